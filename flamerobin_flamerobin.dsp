@@ -572,6 +572,10 @@ SOURCE=.\src\gui\StatementHistoryDialog.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\core\DateTimeFormat.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\core\StringUtils.cpp
 # End Source File
 # Begin Source File
@@ -1066,6 +1070,10 @@ SOURCE=.\src\gui\StatementHistoryDialog.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\core\DateTimeFormat.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\core\StringUtils.h
 # End Source File
 # Begin Source File
@@ -134,6 +134,7 @@ FLAMEROBIN_OBJECTS =  &
 	watu$(R_OPT)$(D_OPT)\flamerobin_FRInt128.obj &
 	watu$(R_OPT)$(D_OPT)\flamerobin_Observer.obj &
 	watu$(R_OPT)$(D_OPT)\flamerobin_ProgressIndicator.obj &
+	watu$(R_OPT)$(D_OPT)\flamerobin_DateTimeFormat.obj &
 	watu$(R_OPT)$(D_OPT)\flamerobin_StringUtils.obj &
 	watu$(R_OPT)$(D_OPT)\flamerobin_Subject.obj &
 	watu$(R_OPT)$(D_OPT)\flamerobin_TemplateProcessor.obj &
@@ -353,6 +354,9 @@ watu$(R_OPT)$(D_OPT)\flamerobin_Observer.obj :  .AUTODEPEND .\src\core\Observer.
 watu$(R_OPT)$(D_OPT)\flamerobin_ProgressIndicator.obj :  .AUTODEPEND .\src\core\ProgressIndicator.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(FLAMEROBIN_CXXFLAGS) $<
 
+watu$(R_OPT)$(D_OPT)\flamerobin_DateTimeFormat.obj :  .AUTODEPEND .\src\core\DateTimeFormat.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(FLAMEROBIN_CXXFLAGS) $<
+
 watu$(R_OPT)$(D_OPT)\flamerobin_StringUtils.obj :  .AUTODEPEND .\src\core\StringUtils.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(FLAMEROBIN_CXXFLAGS) $<
 
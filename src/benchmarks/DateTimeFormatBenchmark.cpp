@@ -0,0 +1,122 @@
+/*
+  Copyright (c) 2004-2022 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Timestamp formatting benchmark: decodes and formats timestamps the way
+// GridCellFormats::formatTimestamp() does for grid cells and exports, and
+// reports the throughput.
+//
+// Usage: datetimeformat_benchmark [count [format]]
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/init.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <ibpp.h>
+
+#include "core/DateTimeFormat.h"
+
+int main(int argc, char* argv[])
+{
+    wxInitializer initializer;
+    if (!initializer)
+    {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return 1;
+    }
+
+    int count = 10000000;
+    if (argc > 1)
+        count = atoi(argv[1]);
+    wxString format("D.N.Y H:M:S.T");
+    if (argc > 2)
+        format = argv[2];
+
+    // same definitions as the timestamp format in GridCellFormats
+    static const DateTimeFormat::FieldDef timestampDefs[] = {
+        { 'd', DateTimeFormat::ffDay, 1 }, { 'D', DateTimeFormat::ffDay, 2 },
+        { 'n', DateTimeFormat::ffMonth, 1 },
+        { 'N', DateTimeFormat::ffMonth, 2 },
+        { 'y', DateTimeFormat::ffYear2, 2 }, { 'Y', DateTimeFormat::ffYear, 4 },
+        { 'h', DateTimeFormat::ffHour, 1 }, { 'H', DateTimeFormat::ffHour, 2 },
+        { 'm', DateTimeFormat::ffMinute, 1 },
+        { 'M', DateTimeFormat::ffMinute, 2 },
+        { 's', DateTimeFormat::ffSecond, 1 },
+        { 'S', DateTimeFormat::ffSecond, 2 },
+        { 'T', DateTimeFormat::ffMilliseconds, 3 },
+        { 0, DateTimeFormat::ffText, 0 }
+    };
+    DateTimeFormat compiledFormat;
+    compiledFormat.compile(format, timestampDefs);
+
+    // a century of days, and times spread over the whole day
+    const int firstDay = IBPP::Date(1950, 1, 1).GetDate();
+    const int days = 36525;
+    const int tenthousandthsPerDay = 24 * 60 * 60 * 10000;
+
+    auto start = std::chrono::steady_clock::now();
+
+    IBPP::Timestamp ts;
+    size_t totalLength = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        ts.SetDate(firstDay + i % days);
+        ts.SetTime(IBPP::Time::tmNone,
+            int((i * 7919LL) % tenthousandthsPerDay), 0);
+
+        int year, month, day, hour, minute, second, tenththousands;
+        ts.GetDate(year, month, day);
+        ts.GetTime(hour, minute, second, tenththousands);
+
+        int values[DateTimeFormat::ffCount] = { 0 };
+        values[DateTimeFormat::ffDay] = day;
+        values[DateTimeFormat::ffMonth] = month;
+        values[DateTimeFormat::ffYear] = year;
+        values[DateTimeFormat::ffYear2] = year % 100;
+        values[DateTimeFormat::ffHour] = hour;
+        values[DateTimeFormat::ffMinute] = minute;
+        values[DateTimeFormat::ffSecond] = second;
+        values[DateTimeFormat::ffMilliseconds] = tenththousands / 10;
+        totalLength += compiledFormat.format(values).length();
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    printf("format:      %s\n", (const char*)format.mb_str());
+    printf("timestamps:  %d (%lu characters)\n", count,
+        (unsigned long)totalLength);
+    printf("elapsed:     %.3f s, %.0f timestamps/s\n", elapsed.count(),
+        count / elapsed.count());
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+  Copyright (c) 2004-2022 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Tokenizer benchmark: splits and classifies a large SQL script the way
+// the SQL editor does, and reports the token throughput.
+//
+// Usage: sqltokenizer_benchmark [statements | script.sql]
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/ffile.h>
+#include <wx/init.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "sql/SqlTokenizer.h"
+
+static wxString createScript(int statements)
+{
+    const wxString templates[] = {
+        "SELECT c.CUSTOMER_ID, c.\"Name\", SUM(o.TOTAL) AS TOTAL\n"
+        "FROM CUSTOMERS c\n"
+        "  JOIN ORDERS o ON o.CUSTOMER_ID = c.CUSTOMER_ID\n"
+        "WHERE o.ORDER_DATE >= '2020-01-01' -- only recent orders\n"
+        "GROUP BY c.CUSTOMER_ID, c.\"Name\";\n",
+        "insert into order_lines (order_id, line_no, product_id, qty)\n"
+        "  values (%d, 1, 4711, 3);\n",
+        "/* keep the statistics up to date */\n"
+        "SET STATISTICS INDEX IDX_ORDERS_%d;\n",
+        "update Products set Price = Price * 1.05, Note = 'it''s %d'\n"
+        "where Category in ('A', 'B') and not Discontinued;\n"
+    };
+    const int templateCount = sizeof(templates) / sizeof(templates[0]);
+
+    wxString script;
+    script.reserve(statements * 100);
+    for (int i = 0; i < statements; ++i)
+    {
+        const wxString& t = templates[i % templateCount];
+        if (t.Find("%d") != wxNOT_FOUND)
+            script += wxString::Format(t, i);
+        else
+            script += t;
+    }
+    return script;
+}
+
+int main(int argc, char* argv[])
+{
+    wxInitializer initializer;
+    if (!initializer)
+    {
+        fprintf(stderr, "Failed to initialize wxWidgets.\n");
+        return 1;
+    }
+
+    wxString script;
+    if (argc > 1 && atoi(argv[1]) <= 0)
+    {
+        wxFFile file(argv[1]);
+        if (!file.IsOpened() || !file.ReadAll(&script))
+        {
+            fprintf(stderr, "Can't read \"%s\".\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+        script = createScript(argc > 1 ? atoi(argv[1]) : 100000);
+
+    const int runs = 5;
+    double bestSeconds = 0;
+    long tokens = 0, keywords = 0, identifiers = 0, terminators = 0;
+    for (int run = 0; run < runs; ++run)
+    {
+        tokens = keywords = identifiers = terminators = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        SqlTokenizer tokenizer(script);
+        do
+        {
+            SqlTokenType type = tokenizer.getCurrentToken();
+            ++tokens;
+            if (tokenizer.isKeywordToken())
+                ++keywords;
+            else if (type == tkIDENTIFIER)
+                ++identifiers;
+            else if (type == tkTERM)
+                ++terminators;
+        }
+        while (tokenizer.nextToken());
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < bestSeconds)
+            bestSeconds = elapsed.count();
+    }
+
+    printf("script:      %lu characters\n", (unsigned long)script.length());
+    printf("tokens:      %ld (%ld keywords, %ld identifiers, %ld statements)\n",
+        tokens, keywords, identifiers, terminators);
+    printf("best of %d:  %.3f s, %.0f tokens/s, %.1f MChars/s\n", runs,
+        bestSeconds, tokens / bestSeconds,
+        script.length() / bestSeconds / 1e6);
+    return 0;
+}
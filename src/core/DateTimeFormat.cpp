@@ -0,0 +1,136 @@
+/*
+  Copyright (c) 2004-2022 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/DateTimeFormat.h"
+
+DateTimeFormat::DateTimeFormat()
+    : maxLengthM(0)
+{
+}
+
+void DateTimeFormat::compile(const wxString& format, const FieldDef* defs)
+{
+    itemsM.clear();
+    maxLengthM = 0;
+    for (wxString::const_iterator c = format.begin(); c != format.end(); c++)
+    {
+        const FieldDef* def = defs;
+        while (def->c != 0 && def->c != wxChar(*c))
+            def++;
+        if (def->c != 0)
+        {
+            Item item = { def->field, def->width, wxEmptyString };
+            itemsM.push_back(item);
+            // sign and digits of an int
+            maxLengthM += 11;
+        }
+        else
+        {
+            if (itemsM.empty() || itemsM.back().field != ffText)
+            {
+                Item item = { ffText, 0, wxEmptyString };
+                itemsM.push_back(item);
+            }
+            itemsM.back().text += *c;
+            maxLengthM++;
+        }
+    }
+}
+
+/*static*/
+wxChar* DateTimeFormat::formatNumber(wxChar* p, int value, int width)
+{
+    static const char digitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233"
+        "34353637383940414243444546474849505152535455565758596061626364656667"
+        "6869707172737475767778798081828384858687888990919293949596979899";
+
+    unsigned u = value;
+    if (value < 0)
+    {
+        *p++ = '-';
+        u = 0u - u;
+        width--;
+    }
+    // digits in reverse order
+    wxChar digits[10];
+    int count = 0;
+    while (u >= 100)
+    {
+        unsigned pair = 2 * (u % 100);
+        u /= 100;
+        digits[count++] = digitPairs[pair + 1];
+        digits[count++] = digitPairs[pair];
+    }
+    if (u >= 10)
+    {
+        digits[count++] = digitPairs[2 * u + 1];
+        digits[count++] = digitPairs[2 * u];
+    }
+    else
+        digits[count++] = wxChar('0' + u);
+
+    for (; width > count; width--)
+        *p++ = '0';
+    while (count > 0)
+        *p++ = digits[--count];
+    return p;
+}
+
+wxString DateTimeFormat::format(const int* values) const
+{
+    wxChar buffer[128];
+    std::vector<wxChar> largeBuffer;
+    wxChar* start = buffer;
+    if (maxLengthM > sizeof(buffer) / sizeof(wxChar))
+    {
+        largeBuffer.resize(maxLengthM);
+        start = &largeBuffer[0];
+    }
+
+    wxChar* p = start;
+    for (std::vector<Item>::const_iterator it = itemsM.begin();
+        it != itemsM.end(); ++it)
+    {
+        if ((*it).field == ffText)
+        {
+            for (wxString::const_iterator c = (*it).text.begin();
+                c != (*it).text.end(); ++c)
+            {
+                *p++ = *c;
+            }
+        }
+        else
+            p = formatNumber(p, values[(*it).field], (*it).width);
+    }
+    return wxString(start, p - start);
+}
@@ -0,0 +1,67 @@
+/*
+  Copyright (c) 2004-2022 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATETIMEFORMAT_H
+#define FR_DATETIMEFORMAT_H
+
+#include <wx/string.h>
+
+#include <vector>
+
+// DateTimeFormat: a date, time or timestamp format string compiled into a
+// list of literal texts and numeric fields, so values can be formatted
+// without interpreting the format string again
+class DateTimeFormat
+{
+public:
+    enum Field { ffText, ffDay, ffMonth, ffYear, ffYear2, ffHour,
+        ffMinute, ffSecond, ffMilliseconds, ffCount };
+    // maps a format character to the field it stands for, arrays of these
+    // are terminated by an entry with c == 0
+    struct FieldDef
+    {
+        wxChar c;
+        Field field;
+        int width;
+    };
+private:
+    struct Item
+    {
+        Field field;
+        int width;
+        wxString text;
+    };
+    std::vector<Item> itemsM;
+    size_t maxLengthM;
+public:
+    DateTimeFormat();
+
+    void compile(const wxString& format, const FieldDef* defs);
+    // values has ffCount elements and is indexed by Field
+    wxString format(const int* values) const;
+
+    // writes value like "%0*d" would, returns the position after the last char
+    static wxChar* formatNumber(wxChar* p, int value, int width);
+};
+
+#endif // FR_DATETIMEFORMAT_H
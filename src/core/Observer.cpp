@@ -31,9 +31,6 @@
 #endif
 
 
-#include <algorithm>
-#include <list>
-
 #include "core/Observer.h"
 #include "core/Subject.h"
 
@@ -68,7 +65,7 @@ Observer::~Observer()
 {
     while (!subjectsM.empty())
     {
-        std::list<Subject*>::iterator it = subjectsM.begin();
+        std::unordered_set<Subject*>::iterator it = subjectsM.begin();
         // object will be removed by removeObservedObject()
         (*it)->detachObserver(this);
     }
@@ -84,18 +81,13 @@ void Observer::doUpdate()
 void Observer::addSubject(Subject* subject)
 {
     if (subject)
-        subjectsM.push_back(subject);
+        subjectsM.insert(subject);
 }
 
 void Observer::removeSubject(Subject* subject)
 {
-    std::list<Subject*>::iterator it = find(subjectsM.begin(),
-        subjectsM.end(), subject);
-    if (it != subjectsM.end())
-    {
-        subjectsM.erase(it);
+    if (subjectsM.erase(subject))
         subjectRemoved(subject);
-    }
 }
 
 void Observer::subjectRemoved(Subject* /*subject*/)
@@ -24,7 +24,7 @@
 #ifndef FR_OBSERVER_H
 #define FR_OBSERVER_H
 
-#include <list>
+#include <unordered_set>
 
 class Subject;
 
@@ -33,7 +33,7 @@ class Observer
 private:
     unsigned updateLockM;
     // pointer to objects that it is watching
-    std::list<Subject*> subjectsM;
+    std::unordered_set<Subject*> subjectsM;
 
     // following methods are only called from Subject
     friend class Subject;
@@ -62,7 +62,4 @@ wxString loadEntireFile(const wxFileName& filename);
 //  Code adapted from wxWidgets' wxTextWrapper function.
 wxString wrapText(const wxString& text, size_t maxWidth, size_t indent);
 
-
-wxString IBPPtype2string(Database* db, IBPP::SDT t, int subtype, int size, int scale);
-
 #endif // FR_STRINGUTILS_H
@@ -30,17 +30,35 @@
 #include "wx/wx.h"
 #endif
 
-#include <algorithm>
-#include <list>
-
 #include "core/Observer.h"
 #include "core/Subject.h"
 
-typedef std::list<Observer*> ObserverList;
+// keeps the observer vector from being compacted while it is looped over
+class ObserverIterationLocker
+{
+private:
+    unsigned* lockPtrM;
+public:
+    ObserverIterationLocker(unsigned* lock);
+    ~ObserverIterationLocker();
+};
+
+ObserverIterationLocker::ObserverIterationLocker(unsigned* lock)
+    : lockPtrM(lock)
+{
+    ++(*lockPtrM);
+}
+
+ObserverIterationLocker::~ObserverIterationLocker()
+{
+    --(*lockPtrM);
+}
 
 Subject::Subject()
 {
     locksCountM = 0;
+    detachedObserversM = 0;
+    iterationLockM = 0;
     needsNotifyObjectsM = false;
 }
 
@@ -51,10 +69,10 @@ Subject::~Subject()
 
 void Subject::attachObserver(Observer* observer, bool callUpdate)
 {
-    if (observer && observersM.end() == std::find(observersM.begin(),
-        observersM.end(), observer))
+    if (observer && !isObservedBy(observer))
     {
         observer->addSubject(this);
+        observerPositionsM[observer] = observersM.size();
         observersM.push_back(observer);
         if (callUpdate)
             observer->doUpdate();
@@ -67,30 +85,59 @@ void Subject::detachObserver(Observer* observer)
         return;
 
     observer->removeSubject(this);
-    ObserverList::iterator it = find(observersM.begin(), observersM.end(),
-        observer);
-    if (it != observersM.end())
-        observersM.erase(it);
+    std::unordered_map<Observer*, size_t>::iterator it =
+        observerPositionsM.find(observer);
+    if (it != observerPositionsM.end())
+    {
+        observersM[(*it).second] = 0;
+        observerPositionsM.erase(it);
+        ++detachedObserversM;
+        compactObservers();
+    }
 }
 
 void Subject::detachAllObservers()
 {
-    ObserverList orig(observersM);
     // make sure there are no reentrancy problems
-    // loop over the items in the original list, but ignore all observers
-    // which have already been removed from the original list
-    for (ObserverList::iterator it = orig.begin(); it != orig.end(); ++it)
+    // observers removed while looping leave null entries behind, so
+    // they are skipped
     {
-        if (isObservedBy(*it))
-            (*it)->removeSubject(this);
+        ObserverIterationLocker lock(&iterationLockM);
+        for (size_t i = 0; i < observersM.size(); ++i)
+        {
+            if (Observer* observer = observersM[i])
+                observer->removeSubject(this);
+        }
     }
     observersM.clear();
+    observerPositionsM.clear();
+    detachedObserversM = 0;
+}
+
+void Subject::compactObservers()
+{
+    // removing the null entries is linear, so only do it when at least
+    // half of the entries are null, which makes detaching amortized O(1)
+    if (iterationLockM > 0 || 2 * detachedObserversM < observersM.size())
+        return;
+
+    size_t count = 0;
+    for (size_t i = 0; i < observersM.size(); ++i)
+    {
+        if (Observer* observer = observersM[i])
+        {
+            observersM[count] = observer;
+            observerPositionsM[observer] = count;
+            ++count;
+        }
+    }
+    observersM.resize(count);
+    detachedObserversM = 0;
 }
 
 bool Subject::isObservedBy(Observer* observer) const
 {
-    return observersM.end() != std::find(observersM.begin(),
-        observersM.end(), observer);
+    return observerPositionsM.find(observer) != observerPositionsM.end();
 }
 
 void Subject::notifyObservers()
@@ -99,16 +146,20 @@ void Subject::notifyObservers()
         needsNotifyObjectsM = true;
     else
     {
-        ObserverList orig(observersM);
-        // make sure there are no reentrancy problems
-        // loop over the items in the original list, but ignore all observers
-        // which have already been removed from the original list
-        for (ObserverList::iterator it = orig.begin(); it != orig.end(); ++it)
+        needsNotifyObjectsM = false;
         {
-            if (isObservedBy(*it))
-                (*it)->doUpdate();
+            // make sure there are no reentrancy problems
+            // only the observers attached before the loop are updated,
+            // and those detached in the meantime are null
+            ObserverIterationLocker lock(&iterationLockM);
+            size_t count = observersM.size();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (Observer* observer = observersM[i])
+                    observer->doUpdate();
+            }
         }
-        needsNotifyObjectsM = false;
+        compactObservers();
     }
 }
 
@@ -24,7 +24,8 @@
 #ifndef FR_SUBJECT_H
 #define FR_SUBJECT_H
 
-#include <list>
+#include <cstddef>
+#include <unordered_map>
 #include <vector>
 
 class Observer;
@@ -35,10 +36,17 @@ private:
     friend class SubjectLocker;
 
     unsigned int locksCountM;
-    std::list<Observer*> observersM;
+    // observers in the order they were attached, with the positions in a
+    // map for constant time lookup; detached observers leave null entries
+    // behind, which are removed when no loop over the observers is active
+    std::vector<Observer*> observersM;
+    std::unordered_map<Observer*, std::size_t> observerPositionsM;
+    std::size_t detachedObserversM;
+    unsigned int iterationLockM;
     bool needsNotifyObjectsM;
 
     void detachAllObservers();
+    void compactObservers();
     bool isObservedBy(Observer* observer) const;
 protected:
     // make these protected, as instances of this class are bogus...
@@ -41,6 +41,10 @@
 #include "TemplateProcessor.h"
 
 #include <algorithm>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 TemplateProcessor::TemplateProcessor(ProcessableObject* object, wxWindow* window)
     : objectM(object), windowM(window)
@@ -393,54 +397,76 @@ void TemplateProcessor::processCommand(const wxString& cmdName,
     }
 }
 
-void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
-    const wxString& inputText, ProcessableObject* object)
+namespace
 {
-    if (object == 0)
-        object = objectM;
 
-    // parse commands
+// a part of a template text: the literal text before a command and the
+// command itself (empty for the text after the last command)
+struct TemplateSegment
+{
+    wxString text;
+    wxString cmdName;
+    TemplateCmdParams cmdParams;
+};
+
+struct ParsedTemplate
+{
+    std::vector<TemplateSegment> segments;
+    // total length of the literal text, to reserve the output buffer
+    size_t textLength;
+};
+
+typedef std::shared_ptr<const ParsedTemplate> ParsedTemplatePtr;
+
+ParsedTemplatePtr parseTemplateText(const wxString& inputText)
+{
+    std::shared_ptr<ParsedTemplate> parsed(new ParsedTemplate);
+    parsed->textLength = 0;
+
     wxString::size_type pos = 0, oldpos = 0, endpos = 0;
+    const wxString::size_type len = inputText.length();
     while (true)
     {
+        TemplateSegment segment;
         pos = inputText.find("{%", pos);
         if (pos == wxString::npos)
         {
-            processedText += inputText.substr(oldpos);
+            segment.text = inputText.substr(oldpos);
+            parsed->textLength += segment.text.length();
+            parsed->segments.push_back(segment);
             break;
         }
 
-        wxString::size_type check, startpos = pos;
+        // find the matching %}, counting nested {% in one pass
         int cnt = 1;
-        while (cnt > 0)
+        for (wxString::size_type i = pos + 1; i + 1 < len; ++i)
         {
-            endpos = inputText.find("%}", startpos+1);
-            if (endpos == wxString::npos)
-                break;
-
-            check = inputText.find("{%", startpos+1);
-            if (check == wxString::npos)
-                startpos = endpos;
-            else
+            wxChar c = inputText[i];
+            if (c == '{' && inputText[i + 1] == '%')
             {
-                startpos = (check < endpos ? check : endpos);
-                if (startpos == check)
-                    cnt++;
+                cnt++;
+                i++;    // skip the second char of the marker
+            }
+            else if (c == '%' && inputText[i + 1] == '}')
+            {
+                if (--cnt == 0)
+                {
+                    endpos = i;
+                    break;
+                }
+                i++;
             }
-            if (startpos == endpos)
-                cnt--;
-            startpos++;
         }
 
         if (cnt > 0)    // no matching closing %}
             break;
 
-        processedText += inputText.substr(oldpos, pos - oldpos);
+        segment.text = inputText.substr(oldpos, pos - oldpos);
+        parsed->textLength += segment.text.length();
         wxString cmd = inputText.substr(pos + 2, endpos - pos - 2); // 2 = start_marker_len = end_marker_len
 
         // parse command name and params.
-        wxString cmdName;
-        TemplateCmdParams cmdParams;
+        TemplateCmdParams& cmdParams = segment.cmdParams;
 
         enum TemplateCmdState
         {
@@ -449,7 +475,7 @@ void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
             inString2
         };
         TemplateCmdState state = inText;
-        wxString buffer;
+        wxString::size_type bufferStart = 0;
         unsigned int nestLevel = 0;
         for (wxString::size_type i = 0; i < cmd.Length(); i++)
         {
@@ -459,12 +485,11 @@ void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
             {
                 if ((nestLevel == 0) && (state == inText))
                 {
-                    cmdParams.Add(buffer);
-                    buffer.Clear();
+                    cmdParams.Add(cmd.substr(bufferStart, i - bufferStart));
+                    bufferStart = i + 1;
                     continue;
                 }
             }
-            buffer += c;
 
             if ((c == '{') && (i < cmd.Length() - 1) && (cmd[i + 1] == '%'))
                 nestLevel++;
@@ -475,18 +500,92 @@ void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
             else if (c == '"')
                 state == inString2 ? state = inText : state = inString2;
         }
-        if (buffer.Length() > 0)
-            cmdParams.Add(buffer);
+        if (bufferStart < cmd.Length())
+            cmdParams.Add(cmd.substr(bufferStart));
 
         if (cmdParams.Count() > 0)
         {
-            cmdName = cmdParams[0];
+            segment.cmdName = cmdParams[0];
             cmdParams.RemoveAt(0);
-            if (!cmdName.IsEmpty())
-                processCommand(cmdName, cmdParams, object, processedText);
         }
+        parsed->segments.push_back(segment);
         oldpos = pos = endpos + 2;
     }
+    return parsed;
+}
+
+// templates are processed recursively, with the command parameters as
+// template texts, so all texts are parsed only once and kept here
+ParsedTemplatePtr getParsedTemplate(const wxString& inputText)
+{
+    typedef std::unordered_map<wxString, ParsedTemplatePtr, wxStringHash,
+        wxStringEqual> ParsedTemplateMap;
+    static ParsedTemplateMap cache;
+
+    ParsedTemplateMap::iterator it = cache.find(inputText);
+    if (it != cache.end())
+        return (*it).second;
+
+    // texts with substituted values (like in {%forall%}) may be unique,
+    // so start over instead of growing without bounds
+    const size_t maxCachedTemplates = 10000;
+    if (cache.size() >= maxCachedTemplates)
+        cache.clear();
+    ParsedTemplatePtr parsed(parseTemplateText(inputText));
+    cache[inputText] = parsed;
+    return parsed;
+}
+
+// the contents of template files by path, reloaded when the file changes
+wxString loadTemplateFile(const wxFileName& fileName)
+{
+    struct CachedFile
+    {
+        wxDateTime modified;
+        wxString contents;
+    };
+    static std::map<wxString, CachedFile> cache;
+
+    wxString path(fileName.GetFullPath());
+    wxDateTime modified;
+    if (fileName.FileExists())
+        modified = fileName.GetModificationTime();
+
+    std::map<wxString, CachedFile>::iterator it = cache.find(path);
+    if (it != cache.end() && modified.IsValid()
+        && (*it).second.modified == modified)
+    {
+        return (*it).second.contents;
+    }
+
+    CachedFile file;
+    file.modified = modified;
+    file.contents = loadEntireFile(fileName);
+    cache[path] = file;
+    return file.contents;
+}
+
+} // namespace
+
+void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
+    const wxString& inputText, ProcessableObject* object)
+{
+    if (object == 0)
+        object = objectM;
+
+    // keep a reference, the cache may be cleared by nested calls
+    ParsedTemplatePtr parsed(getParsedTemplate(inputText));
+    processedText.reserve(processedText.length() + parsed->textLength);
+    for (std::vector<TemplateSegment>::const_iterator it =
+        parsed->segments.begin(); it != parsed->segments.end(); ++it)
+    {
+        processedText += (*it).text;
+        if (!(*it).cmdName.IsEmpty())
+        {
+            processCommand((*it).cmdName, (*it).cmdParams, object,
+                processedText);
+        }
+    }
 }
 
 void TemplateProcessor::processTemplateFile(wxString& processedText,
@@ -506,7 +605,7 @@ void TemplateProcessor::processTemplateFile(wxString& processedText,
     confFileName.SetExt("conf");
     configM.setConfigFileName(confFileName);
     progressIndicatorM = progressIndicator;
-    internalProcessTemplateText(processedText, loadEntireFile(fileNameM),
+    internalProcessTemplateText(processedText, loadTemplateFile(fileNameM),
         object);
 }
 
@@ -602,15 +701,35 @@ void TemplateCmdHandlerRepository::handleTemplateCmd(TemplateProcessor *tp,
     const wxString& cmdName, const TemplateCmdParams& cmdParams,
     ProcessableObject* object, wxString& processedText)
 {
-    checkHandlerListSorted();
-    for (std::list<TemplateCmdHandler*>::iterator it = handlersM.begin();
-        it != handlersM.end(); ++it)
+    // copy, as handlers could be added or removed while processing
+    std::vector<TemplateCmdHandler*> handlers(getHandlers(cmdName));
+    for (std::vector<TemplateCmdHandler*>::iterator it = handlers.begin();
+        it != handlers.end(); ++it)
     {
         (*it)->handleTemplateCmd(tp, cmdName, cmdParams, object,
             processedText);
     }
 }
 
+const std::vector<TemplateCmdHandler*>&
+    TemplateCmdHandlerRepository::getHandlers(const wxString& cmdName)
+{
+    HandlersByNameMap::iterator it = handlersByNameM.find(cmdName);
+    if (it != handlersByNameM.end())
+        return (*it).second;
+
+    checkHandlerListSorted();
+    std::vector<TemplateCmdHandler*>& handlers = handlersByNameM[cmdName];
+    for (std::list<TemplateCmdHandler*>::iterator ith = handlersM.begin();
+        ith != handlersM.end(); ++ith)
+    {
+        wxArrayString names((*ith)->getCommandNames());
+        if (names.IsEmpty() || names.Index(cmdName) != wxNOT_FOUND)
+            handlers.push_back(*ith);
+    }
+    return handlers;
+}
+
 void TemplateCmdHandlerRepository::addHandler(TemplateCmdHandler* handler)
 {
     // can't do ordered insert here, since the getPosition() function that
@@ -620,12 +739,14 @@ void TemplateCmdHandlerRepository::addHandler(TemplateCmdHandler* handler)
     handlersM.push_back(handler);
     handler->setRepository(this);
     handlerListSortedM = false;
+    handlersByNameM.clear();
 }
 
 void TemplateCmdHandlerRepository::removeHandler(TemplateCmdHandler* handler)
 {
     handlersM.erase(std::find(handlersM.begin(), handlersM.end(), handler));
     handler->setRepository(0);
+    handlersByNameM.clear();
 }
 
 TemplateCmdHandler::TemplateCmdHandler() :
@@ -27,9 +27,12 @@
 
 #include <wx/filename.h>
 #include <wx/arrstr.h>
+#include <wx/hashmap.h>
 
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "config/Config.h"
 #include "core/ProcessableObject.h"
@@ -127,6 +130,14 @@ private:
     bool handlerListSortedM;
     void checkHandlerListSorted();
 
+    // the handlers offered each command, filled on demand and cleared
+    // whenever handlers are added or removed
+    typedef std::unordered_map<wxString, std::vector<TemplateCmdHandler*>,
+        wxStringHash, wxStringEqual> HandlersByNameMap;
+    HandlersByNameMap handlersByNameM;
+    const std::vector<TemplateCmdHandler*>& getHandlers(
+        const wxString& cmdName);
+
     // only getTemplateCmdHandlerRepository() may instantiate an object of this class.
     friend TemplateCmdHandlerRepository& getTemplateCmdHandlerRepository();
 
@@ -155,6 +166,13 @@ public:
     {
         return getPosition() < right.getPosition();
     }
+    // Returns the names of the commands this handler processes, so it is
+    // only offered those. The default (an empty array) offers it all
+    // commands.
+    virtual wxArrayString getCommandNames() const
+    {
+        return wxArrayString();
+    }
 protected:
     virtual int getPosition() const
     {
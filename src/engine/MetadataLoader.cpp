@@ -30,6 +30,11 @@
     #include "wx/wx.h"
 #endif
 
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+
+#include "core/FRError.h"
 #include "engine/MetadataLoader.h"
 #include "metadata/database.h"
 
@@ -39,6 +44,12 @@ MetadataLoader::MetadataLoader(Database& database, unsigned maxStatements)
 {
 }
 
+MetadataLoader::MetadataLoader(IBPP::Database database, unsigned maxStatements)
+    : databaseM(database), transactionM(), transactionLevelM(0),
+        statementsM(), maxStatementsM(maxStatements)
+{
+}
+
 void MetadataLoader::transactionStart()
 {
     ++transactionLevelM;
@@ -166,3 +177,151 @@ MetadataLoaderTransaction::~MetadataLoaderTransaction()
         loaderM->transactionCommit();
 }
 
+
+MetadataRows::MetadataRows(IBPP::Statement statement, RowList* recordedRows)
+    : statementM(statement), recordedRowsM(recordedRows), rowsM(0),
+        nextRowM(0), rowM(), hasRowM(false)
+{
+}
+
+MetadataRows::MetadataRows(const RowList& rows)
+    : statementM(), recordedRowsM(0), rowsM(&rows), nextRowM(0), rowM(),
+        hasRowM(false)
+{
+}
+
+bool MetadataRows::fetch()
+{
+    if (rowsM)
+    {
+        // cached rows are read with nextRowM pointing past the current one
+        hasRowM = nextRowM < rowsM->size();
+        if (hasRowM)
+            ++nextRowM;
+        return hasRowM;
+    }
+
+    hasRowM = statementM->Fetch();
+    if (hasRowM)
+    {
+        readRow();
+        if (recordedRowsM)
+            recordedRowsM->push_back(rowM);
+    }
+    return hasRowM;
+}
+
+void MetadataRows::readRow()
+{
+    int count = statementM->Columns();
+    rowM.resize(count);
+    for (int i = 1; i <= count; ++i)
+    {
+        Value& value = rowM[i - 1];
+        value.data.clear();
+        value.isNull = statementM->IsNull(i);
+        if (value.isNull)
+            continue;
+
+        switch (statementM->ColumnType(i))
+        {
+            case IBPP::sdBlob:
+            {
+                IBPP::Blob b = IBPP::BlobFactory(statementM->DatabasePtr(),
+                    statementM->TransactionPtr());
+                statementM->Get(i, b);
+                // opening an empty blob throws, see readBlob() in frutils
+                try
+                {
+                    b->Open();
+                }
+                catch (...)
+                {
+                    break;
+                }
+                char buffer[8192];
+                int size;
+                while ((size = b->Read(buffer, sizeof(buffer))) > 0)
+                    value.data.append(buffer, size);
+                b->Close();
+                break;
+            }
+            case IBPP::sdSmallint:
+            case IBPP::sdInteger:
+            case IBPP::sdLargeint:
+            {
+                int64_t n;
+                statementM->Get(i, n);
+                value.data = std::to_string(n);
+                break;
+            }
+            case IBPP::sdFloat:
+            case IBPP::sdDouble:
+            {
+                double d;
+                statementM->Get(i, d);
+                std::ostringstream os;
+                os.imbue(std::locale::classic());
+                os.precision(17);
+                os << d;
+                value.data = os.str();
+                break;
+            }
+            case IBPP::sdBoolean:
+            {
+                bool b;
+                statementM->Get(i, b);
+                value.data = b ? "1" : "0";
+                break;
+            }
+            default:
+                statementM->Get(i, value.data);
+                break;
+        }
+    }
+}
+
+const MetadataRows::Row* MetadataRows::getRow() const
+{
+    if (!hasRowM)
+        return 0;
+    return rowsM ? &(*rowsM)[nextRowM - 1] : &rowM;
+}
+
+const MetadataRows::Value* MetadataRows::getValue(int column) const
+{
+    const Row* row = getRow();
+    if (!row || column < 1 || column > int(row->size()))
+        throw FRError("MetadataRows: invalid column number");
+    return &(*row)[column - 1];
+}
+
+int MetadataRows::columns() const
+{
+    const Row* row = getRow();
+    return row ? int(row->size()) : 0;
+}
+
+bool MetadataRows::isNull(int column) const
+{
+    return getValue(column)->isNull;
+}
+
+const std::string& MetadataRows::getString(int column) const
+{
+    return getValue(column)->data;
+}
+
+int MetadataRows::getInt(int column) const
+{
+    return int(std::strtol(getValue(column)->data.c_str(), 0, 10));
+}
+
+double MetadataRows::getDouble(int column) const
+{
+    std::istringstream is(getValue(column)->data);
+    is.imbue(std::locale::classic());
+    double d = 0;
+    is >> d;
+    return d;
+}
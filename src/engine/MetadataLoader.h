@@ -26,6 +26,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include <ibpp.h>
 
@@ -72,6 +73,9 @@ public:
     // of the statementsM list, and could possibly consume a lot of the
     // available server ressources!
     MetadataLoader(Database& database, unsigned maxStatements = 1);
+    // Creates MetadataLoader object using another attachment of a database,
+    // so metadata can be read by a worker thread
+    MetadataLoader(IBPP::Database database, unsigned maxStatements = 1);
 
     // Creates a prepared IBPP::Statement object for the sql statement.
     // Should be used in cases where sql is unique and can not be reused,
@@ -105,4 +109,50 @@ public:
     ~MetadataLoaderTransaction();
 };
 
+// Rows of an executed metadata statement, or rows read before (from the
+// metadata cache).  All values of the current row are kept as strings, text
+// and blobs with their raw bytes in the connection charset and numbers
+// formatted as text, so the rows can be written to the cache unchanged.
+class MetadataRows
+{
+public:
+    struct Value
+    {
+        bool isNull;
+        std::string data;
+    };
+    typedef std::vector<Value> Row;
+    typedef std::vector<Row> RowList;
+
+private:
+    IBPP::Statement statementM;
+    RowList* recordedRowsM;
+    const RowList* rowsM;
+    size_t nextRowM;
+    Row rowM;
+    bool hasRowM;
+
+    void readRow();
+    const Row* getRow() const;
+    const Value* getValue(int column) const;
+
+public:
+    // Reads the rows of the executed statement, a copy of every row is
+    // appended to recordedRows if that isn't null.
+    MetadataRows(IBPP::Statement statement, RowList* recordedRows = 0);
+    // Returns the rows, which must not be changed while they are read.
+    MetadataRows(const RowList& rows);
+
+    // Moves to the next row like IBPP::IStatement::Fetch(), returns false
+    // if no rows are left.
+    bool fetch();
+
+    // Columns are numbered from 1, like IBPP does.
+    int columns() const;
+    bool isNull(int column) const;
+    const std::string& getString(int column) const;
+    int getInt(int column) const;
+    double getDouble(int column) const;
+};
+
 #endif //FR_METADATALOADER_H
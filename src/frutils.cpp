@@ -33,11 +33,16 @@
 #include <wx/file.h>
 #include <wx/tokenzr.h>
 
+#include <list>
+
 #include "core/StringUtils.h"
+#include "engine/MetadataLoader.h"
 #include "frutils.h"
 #include "gui/ProgressDialog.h"
 #include "gui/UsernamePasswordDialog.h"
+#include "metadata/CharacterSet.h"
 #include "metadata/column.h"
+#include "metadata/database.h"
 #include "metadata/relation.h"
 #include "metadata/server.h"
 #include "config/Config.h"
@@ -97,6 +102,14 @@ void readBlob(IBPP::Statement& st, int column, wxString& result,
     b->Close();
 }
 
+void readBlob(const MetadataRows& rows, int column, wxString& result,
+    wxMBConv* conv)
+{
+    result = "";
+    if (!rows.isNull(column))
+        result = wxString(rows.getString(column).c_str(), *conv);
+}
+
 wxString selectRelationColumns(Relation* t, wxWindow* parent)
 {
     std::vector<wxString> list;
@@ -239,3 +252,37 @@ wxString getClientLibrary()
 #endif
 
 }
+
+wxString IBPPtype2string(Database* db, IBPP::SDT t, int subtype, int size,
+    int scale)
+{
+    if (scale > 0)
+        return wxString::Format("NUMERIC(%d,%d)", size == 4 ? 9 : 18, scale);
+    if (t == IBPP::sdString)
+    {
+        int bpc = db->getCharsetById(subtype)->getBytesPerChar();
+        if (subtype == 1) // charset OCTETS
+            return wxString::Format("OCTETS(%d)", bpc ? size / bpc : size);
+        return wxString::Format("STRING(%d)", bpc ? size / bpc : size);
+    }
+    switch (t)
+    {
+    case IBPP::sdArray:     return "ARRAY";
+    case IBPP::sdBlob:      return wxString::Format("BLOB SUB_TYPE %d", subtype);
+    case IBPP::sdDate:      return "DATE";
+    case IBPP::sdTime:      return "TIME";
+    case IBPP::sdTimestamp: return "TIMESTAMP";
+    case IBPP::sdSmallint:  return "SMALLINT";
+    case IBPP::sdInteger:   return "INTEGER";
+    case IBPP::sdLargeint:  return "BIGINT";
+    case IBPP::sdFloat:     return "FLOAT";
+    case IBPP::sdDouble:    return "DOUBLE PRECISION";
+    case IBPP::sdBoolean:   return "BOOLEAN";
+    case IBPP::sdTimeTz:    return "TIME WITH TIMEZONE";
+    case IBPP::sdTimestampTz: return "TIMESTAMP WITH TIMEZONE";
+    case IBPP::sdInt128:    return "INT128";
+    case IBPP::sdDec16:     return "DECFLOAT(16)";
+    case IBPP::sdDec34:     return "DECFLOAT(34)";
+    default:                return "UNKNOWN";
+    }
+}
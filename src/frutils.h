@@ -33,6 +33,7 @@
 
 #include "metadata/MetadataClasses.h"
 
+class MetadataRows;
 class ProgressDialog;
 class ProgressIndicator;
 
@@ -42,6 +43,9 @@ void adjustControlsMinWidth(std::list<wxWindow*> controls);
 //! reads blob from statement into wxString
 void readBlob(IBPP::Statement& st, int column, wxString& result,
     wxMBConv* conv);
+//! reads blob from the current row of rows into wxString
+void readBlob(const MetadataRows& rows, int column, wxString& result,
+    wxMBConv* conv);
 
 //! displays a list of table columns and lets user select some
 wxString selectRelationColumns(Relation* t, wxWindow* parent);
@@ -59,4 +63,8 @@ wxString unquote(const wxString& input, const wxString& quoteChar = "\"");
 
 wxString getClientLibrary();
 
+//! returns the SQL type name of an IBPP parameter or column type
+wxString IBPPtype2string(Database* db, IBPP::SDT t, int subtype, int size,
+    int scale);
+
 #endif // FRUTILS_H
@@ -71,6 +71,7 @@ enum {
     DataGrid_Copy_as_upins,
     DataGrid_Save_as_html,
     DataGrid_Save_as_csv,
+    DataGrid_Export_all,
     DataGrid_Log_changes,
 
     Menu_RegisterServer = 600,
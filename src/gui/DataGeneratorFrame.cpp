@@ -35,6 +35,7 @@
 #include <wx/file.h>
 
 #include <wx/filename.h>
+#include <wx/stopwatch.h>
 #include <wx/wfstream.h>
 #include <wx/txtstrm.h>
 #include <wx/xml/xml.h>
@@ -42,6 +43,18 @@
 // needed for random
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "config/Config.h"
 #include "core/ArtProvider.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
@@ -55,10 +68,11 @@
 #include "metadata/table.h"
 
 // returns a value between 0 and (maxval-1)
-// I wrote this as I don't know how much is rand from stdlib portable
+// every thread uses its own engine, as rand() isn't thread-safe everywhere
 int frRandom(double maxval)
 {
-    return (int)(maxval*rand()/(RAND_MAX+1.0));
+    static thread_local std::mt19937 engine(std::random_device{}());
+    return (int)(maxval*engine()/(engine.max()+1.0));
 }
 
 // dd.mm.yyyy
@@ -974,12 +988,20 @@ void DataGeneratorFrame::OnGenerateButtonClick(wxCommandEvent& WXUNUSED(event))
     saveSetting(mainTree->GetSelection());  // save current item if changed
 
     std::list<Table *> order;
+    wxString msg(_("Data generation completed."));
     if (sortTables(order))
-        generateData(order);
+    {
+        wxStopWatch sw;
+        wxString report;
+        int records = generateData(order, report);
+        double seconds = sw.Time() / 1000.0;
+        msg += "\n\n" + wxString::Format(
+            _("A total of %d records were inserted in %.1f seconds (%.0f records per second)."),
+            records, seconds, seconds > 0 ? records / seconds : 0.0);
+        msg += "\n" + report;
+    }
 
-    // perhaps add a comment like: "A total of XYZ records were inserted."
-    showInformationDialog(this, _("Generator done"),
-        _("Data generation completed."),
+    showInformationDialog(this, _("Generator done"), msg,
         AdvancedMessageDialogButtonsOk());
 }
 
@@ -1088,8 +1110,147 @@ wxString getCharFromRange(const wxString& range, bool rnd, int recNo,
     return valueset.Mid(record % base, 1);
 }
 
-void setFromFile(IBPP::Statement st, int param,
-    GeneratorSettings *gs, int recNo)
+// values of a column taken from a file or from a column of another table,
+// loaded once per run and then selected for each record
+class GeneratorValueProvider
+{
+public:
+    virtual ~GeneratorValueProvider() {}
+    virtual void setParam(IBPP::Statement& st, int param, int recNo) = 0;
+};
+
+template<typename T>
+class GeneratorValueList: public GeneratorValueProvider
+{
+private:
+    GeneratorSettings* settingsM;
+    bool fromFileM;
+    std::vector<T> valuesM;
+public:
+    GeneratorValueList(GeneratorSettings* gs, bool fromFile)
+        : settingsM(gs), fromFileM(fromFile)
+    {
+    }
+
+    std::vector<T>& getValues()
+    {
+        return valuesM;
+    }
+
+    virtual void setParam(IBPP::Statement& st, int param, int recNo)
+    {
+        if (valuesM.empty())
+        {
+            // empty files leave the parameter alone
+            if (fromFileM)
+                return;
+            if (settingsM->nullPercent > 0)
+            {
+                st->SetNull(param);
+                return;
+            }
+            throw FRError(_("No records found in table: ")
+                + settingsM->sourceTable);
+        }
+
+        if (settingsM->randomValues)
+            st->Set(param, valuesM[frRandom(valuesM.size())]);
+        else
+            st->Set(param, valuesM[recNo % valuesM.size()]);
+    }
+};
+
+// converts a line of a value file to the datatype of the parameter
+void convertFileValue(const wxString& selected, std::string& value)
+{
+    value = wx2std(selected);
+}
+
+void convertFileValue(const wxString& selected, int16_t& value)
+{
+    long l;
+    if (!selected.ToLong(&l))
+        throw FRError(_("Invalid long (smallint) value: ")+selected);
+    value = l;
+}
+
+void convertFileValue(const wxString& selected, int32_t& value)
+{
+    long l;
+    if (!selected.ToLong(&l))
+        throw FRError(_("Invalid long numeric value: ")+selected);
+    value = l;
+}
+
+void convertFileValue(const wxString& selected, int64_t& value)
+{
+    wxLongLong_t ll;
+    if (!selected.ToLongLong(&ll))
+        throw FRError(_("Invalid long long numeric value: ")+selected);
+    value = ll;
+}
+
+void convertFileValue(const wxString& selected, float& value)
+{
+    double d;
+    if (!selected.ToDouble(&d))
+        throw FRError(_("Invalid float value: ")+selected);
+    value = d;
+}
+
+void convertFileValue(const wxString& selected, double& value)
+{
+    if (!selected.ToDouble(&value))
+        throw FRError(_("Invalid double numeric value: ")+selected);
+}
+
+void convertFileValue(const wxString& selected, IBPP::Time& value)
+{
+    int mytime;
+    str2time(selected, mytime);
+    value = IBPP::Time(IBPP::Time::tmNone, mytime, IBPP::Time::TZ_NONE);
+}
+
+void convertFileValue(const wxString& selected, IBPP::Date& value)
+{
+    int mydate;
+    str2date(selected, mydate);
+    value = IBPP::Date(mydate);
+}
+
+void convertFileValue(const wxString& selected, IBPP::Timestamp& value)
+{
+    int mydate, mytime;
+    str2date(selected, mydate);
+    str2time(selected.Mid(11), mytime);
+    int y, mo, d, h, mi, s, t;
+    IBPP::dtoi(mydate, &y, &mo, &d);
+    IBPP::ttoi(mytime, &h, &mi, &s, &t);
+    value = IBPP::Timestamp(y, mo, d, IBPP::Time::tmNone, h, mi, s, t, IBPP::Time::TZ_NONE, NULL);
+}
+
+template<typename T>
+GeneratorValueProvider* createFileValues(GeneratorSettings *gs,
+    const std::vector<wxString>& lines)
+{
+    GeneratorValueList<T>* provider = new GeneratorValueList<T>(gs, true);
+    std::vector<T>& values = provider->getValues();
+    values.resize(lines.size());
+    try
+    {
+        for (size_t i = 0; i < lines.size(); ++i)
+            convertFileValue(lines[i], values[i]);
+    }
+    catch (...)
+    {
+        delete provider;
+        throw;
+    }
+    return provider;
+}
+
+GeneratorValueProvider* createFromFile(IBPP::Statement st, int param,
+    GeneratorSettings *gs)
 {
     // load strings from file to vector
     wxFileInputStream stream(gs->fileName);
@@ -1097,111 +1258,57 @@ void setFromFile(IBPP::Statement st, int param,
         throw FRError(_("Cannot open file: ")+gs->fileName);
     wxTextInputStream text(stream);
 
-    std::vector<wxString> values;
+    std::vector<wxString> lines;
     while (true)
     {
         wxString s = text.ReadLine();
         if (s.IsEmpty())
             break;
-        values.push_back(s);
+        lines.push_back(s);
     }
-    if (values.empty())
-        return;
 
-    // select (random/sequential) string from vector
-    wxString selected;
-    if (gs->randomValues)
-        selected = values[frRandom(values.size())];
-    else
-        selected = values[recNo % values.size()];
-
-    // convert string to datatype
-    int mydate, mytime;
+    // convert strings to datatype
     IBPP::SDT dt = st->ParameterType(param);
     if (st->ParameterScale(param))
         dt = IBPP::sdDouble;
     switch (dt)
     {
         case IBPP::sdBoolean: // Firebird v3
-            st->Set(param, wx2std(selected)); break;
         case IBPP::sdString:
-            st->Set(param, wx2std(selected));   break;
+            return createFileValues<std::string>(gs, lines);
         case IBPP::sdSmallint:
-        {
-            long l;
-            if (!selected.ToLong(&l))
-                throw FRError(_("Invalid long (smallint) value: ")+selected);
-            int16_t t = l;
-            st->Set(param, t);
-            break;
-        }
+            return createFileValues<int16_t>(gs, lines);
         case IBPP::sdLargeint:
-        {
-            wxLongLong_t ll;
-            if (!selected.ToLongLong(&ll))
-                throw FRError(_("Invalid long long numeric value: ")+selected);
-            int64_t t = ll;
-            st->Set(param, t);
-            break;
-        }
+            return createFileValues<int64_t>(gs, lines);
         case IBPP::sdInteger:
-        {
-            long l;
-            if (!selected.ToLong(&l))
-                throw FRError(_("Invalid long numeric value: ")+selected);
-            int32_t t = l;
-            st->Set(param, t);
-            break;
-        }
+            return createFileValues<int32_t>(gs, lines);
         case IBPP::sdFloat:
-        {
-            double d;
-            if (!selected.ToDouble(&d))
-                throw FRError(_("Invalid float value: ")+selected);
-            float f = d;
-            st->Set(param, f);
-            break;
-        }
+            return createFileValues<float>(gs, lines);
         case IBPP::sdDouble:
-        {
-            double d;
-            if (!selected.ToDouble(&d))
-                throw FRError(_("Invalid double numeric value: ")+selected);
-            st->Set(param, d);
-            break;
-        }
+            return createFileValues<double>(gs, lines);
         case IBPP::sdTime:
-            str2time(selected, mytime);
-            st->Set(param, IBPP::Time(IBPP::Time::tmNone, mytime, IBPP::Time::TZ_NONE));
-            break;
+            return createFileValues<IBPP::Time>(gs, lines);
         case IBPP::sdDate:
-            str2date(selected, mydate);
-            st->Set(param, IBPP::Date(mydate));
-            break;
+            return createFileValues<IBPP::Date>(gs, lines);
         case IBPP::sdTimestamp:
-        {
-            str2date(selected, mydate);
-            str2time(selected.Mid(11), mytime);
-            int y, mo, d, h, mi, s, t;
-            IBPP::dtoi(mydate, &y, &mo, &d);
-            IBPP::ttoi(mytime, &h, &mi, &s, &t);
-            st->Set(param, IBPP::Timestamp(y, mo, d, IBPP::Time::tmNone, h, mi, s, t, IBPP::Time::TZ_NONE, NULL));
-            break;
-        }
+            return createFileValues<IBPP::Timestamp>(gs, lines);
         case IBPP::sdBlob:
             throw FRError(_("Blob datatype not supported"));
         case IBPP::sdArray:
             throw FRError(_("Array datatype not supported"));
     };
+    return 0;
 }
 
 template<typename T>
-void setFromOther(IBPP::Statement st, int param,
-    GeneratorSettings *gs, size_t recNo)
+GeneratorValueProvider* createFromOther(IBPP::Statement st,
+    GeneratorSettings *gs)
 {
     IBPP::Statement st2 =
         IBPP::StatementFactory(st->DatabasePtr(), st->TransactionPtr());
 
+    // random values are taken from the first 100 records, sequential ones
+    // from all records in order
     wxString sql = "SELECT " + gs->sourceColumn + " FROM "
         + gs->sourceTable + " WHERE " + gs->sourceColumn
         + " IS NOT NULL";
@@ -1209,35 +1316,65 @@ void setFromOther(IBPP::Statement st, int param,
         sql += " ORDER BY 1";
     st2->Prepare(wx2std(sql));
     st2->Execute();
-    std::vector<T> values;
-    while (st2->Fetch())
+
+    GeneratorValueList<T>* provider = new GeneratorValueList<T>(gs, false);
+    std::vector<T>& values = provider->getValues();
+    try
     {
-        T value;
-        st2->Get(1, value);
-        values.push_back(value);
-        if (values.size() > recNo && !gs->randomValues)
+        while (st2->Fetch())
         {
-            st->Set(param, value);
-            return;
+            T value;
+            st2->Get(1, value);
+            values.push_back(value);
+            if (values.size() > 99 && gs->randomValues)
+                break;
         }
-        if (values.size() > 99 && gs->randomValues)
-            break;
     }
-    if (values.size() == 0)
+    catch (...)
     {
-        if (gs->nullPercent > 0)
-        {
-            st->SetNull(param);
-            return;
-        }
-        else
-            throw FRError(_("No records found in table: ") + gs->sourceTable);
+        delete provider;
+        throw;
     }
+    return provider;
+}
 
-    if (gs->randomValues)
-        st->Set(param, values[frRandom(values.size())]);
-    else
-        st->Set(param, values[recNo % values.size()]);
+GeneratorValueProvider* createValueProvider(IBPP::Statement st, int param,
+    GeneratorSettings* gs)
+{
+    if (gs->valueType == GeneratorSettings::vtFile)
+        return createFromFile(st, param, gs);
+    if (gs->valueType != GeneratorSettings::vtColumn)
+        return 0;
+
+    // copy from column
+    switch (st->ParameterType(param))
+    {
+        case IBPP::sdBoolean: // Firebird v3
+            return createFromOther<std::string>(st, gs);
+        case IBPP::sdString:
+            return createFromOther<std::string>(st, gs);
+        case IBPP::sdSmallint:
+            return createFromOther<int16_t>(st, gs);
+        case IBPP::sdInteger:
+            return createFromOther<int32_t>(st, gs);
+        case IBPP::sdLargeint:
+            return createFromOther<int64_t>(st, gs);
+        case IBPP::sdFloat:
+            return createFromOther<float>(st, gs);
+        case IBPP::sdDouble:
+            return createFromOther<double>(st, gs);
+        case IBPP::sdDate:
+            return createFromOther<IBPP::Date>(st, gs);
+        case IBPP::sdTime:
+            return createFromOther<IBPP::Time>(st, gs);
+        case IBPP::sdTimestamp:
+            return createFromOther<IBPP::Timestamp>(st, gs);
+        case IBPP::sdBlob:
+            throw FRError(_("Blob datatype not supported"));
+        case IBPP::sdArray:
+            throw FRError(_("Array datatype not supported"));
+    };
+    return 0;
 }
 
 // format for values:
@@ -1456,7 +1593,7 @@ void setDatetime(IBPP::Statement st, int param, GeneratorSettings* gs,
 }
 
 void DataGeneratorFrame::setParam(IBPP::Statement st, int param,
-    GeneratorSettings* gs, int recNo)
+    GeneratorSettings* gs, GeneratorValueProvider* provider, int recNo)
 {
     if (gs->nullPercent > frRandom(100))
     {
@@ -1464,35 +1601,10 @@ void DataGeneratorFrame::setParam(IBPP::Statement st, int param,
         return;
     }
 
-    if (gs->valueType == GeneratorSettings::vtColumn)   // copy from column
+    // copy from column or file
+    if (provider)
     {
-        switch (st->ParameterType(param))
-        {
-            case IBPP::sdBoolean: // Firebird v3
-                setFromOther<std::string>(st, param, gs, recNo);  break;
-            case IBPP::sdString:
-                setFromOther<std::string>(st, param, gs, recNo);  break;
-            case IBPP::sdSmallint:
-                setFromOther<int16_t>(st, param, gs, recNo);      break;
-            case IBPP::sdInteger:
-                setFromOther<int32_t>(st, param, gs, recNo);      break;
-            case IBPP::sdLargeint:
-                setFromOther<int64_t>(st, param, gs, recNo);      break;
-            case IBPP::sdFloat:
-                setFromOther<float>(st, param, gs, recNo);        break;
-            case IBPP::sdDouble:
-                setFromOther<double>(st, param, gs, recNo);       break;
-            case IBPP::sdDate:
-                setFromOther<IBPP::Date>(st, param, gs, recNo);   break;
-            case IBPP::sdTime:
-                setFromOther<IBPP::Time>(st, param, gs, recNo);   break;
-            case IBPP::sdTimestamp:
-                setFromOther<IBPP::Timestamp>(st, param, gs, recNo);  break;
-            case IBPP::sdBlob:
-                throw FRError(_("Blob datatype not supported"));
-            case IBPP::sdArray:
-                throw FRError(_("Array datatype not supported"));
-        };
+        provider->setParam(st, param, recNo);
         return;
     }
 
@@ -1527,78 +1639,420 @@ void DataGeneratorFrame::setParam(IBPP::Statement st, int param,
                 st->SetNull(param);
         };
     }
-
-    if (gs->valueType == GeneratorSettings::vtFile)
-        setFromFile(st, param, gs, recNo);
 }
 
-void DataGeneratorFrame::generateData(std::list<Table *>& order)
+// one table to fill, collected on the main thread so the worker threads
+// don't need to access any metadata objects
+struct DataGeneratorJob
 {
-    ProgressDialog pd(this, _("Generating data"), 2);
-    pd.doShow();
-    pd.initProgress(_("Inserting into tables"), order.size());
-
-    // one big transaction (perhaps this should be configurable)
-    IBPP::Transaction tr =
-        IBPP::TransactionFactory(databaseM->getIBPPDatabase());
-    tr->Start();
+    wxString tableName;
+    std::vector<wxString> columnNames;
+    std::vector<GeneratorSettings *> settings;
+    int records;
+    int blockRecords;
+    int commitInterval;
+    // jobs (earlier in the insert order) that have to be done first
+    std::vector<size_t> dependsOn;
+    int inserted;
+    int committed;
+    long milliseconds;
+};
 
+int DataGeneratorFrame::generateData(std::list<Table *>& order,
+    wxString& report)
+{
+    int commitInterval = config().get("DataGeneratorCommitInterval", 0);
+    int blockRecords = config().get("DataGeneratorBlockRecords", 100);
+    // EXECUTE BLOCK parameters declared as TYPE OF COLUMN need Firebird 2.5
+    if (!databaseM->getInfo().getODSVersionIsHigherOrEqualTo(11, 2))
+        blockRecords = 1;
+
+    // collect columns and dependencies of all tables
+    std::vector<DataGeneratorJob> jobs;
+    std::map<wxString, size_t> jobIndex;
+    int totalRecords = 0;
     for (std::list<Table *>::iterator it = order.begin();
         it != order.end(); ++it)
     {
-        pd.setProgressMessage((*it)->getName_(), 1);
-        pd.stepProgress();
+        DataGeneratorJob job;
+        job.tableName = (*it)->getQuotedName();
+        job.records = tableRecordsM[job.tableName];
+        job.blockRecords = blockRecords;
+        job.commitInterval = commitInterval;
+        job.inserted = job.committed = 0;
+        job.milliseconds = 0;
 
-        std::map<wxString, int>::iterator i2 =
-            tableRecordsM.find((*it)->getQuotedName());
-        int records = (*i2).second;
-
-        pd.initProgress(wxString::Format(_("Inserting %d records."), records),
-            records, 0, 2);
-
-        // collect columns + create insert statement
-        wxString ins = "INSERT INTO " + (*it)->getQuotedName()
-            + " (";
-        wxString params(") VALUES (");
         (*it)->ensureChildrenLoaded();
-        bool first = true;
-        std::vector<GeneratorSettings *> colSet;
         for (ColumnPtrs::iterator col = (*it)->begin();
             col != (*it)->end(); ++col)
         {
             GeneratorSettings *gs = getSettings((*col).get());   // load or create
             if (gs->valueType == GeneratorSettings::vtSkip)
                 continue;
+            job.columnNames.push_back((*col)->getQuotedName());
+            job.settings.push_back(gs);
 
-            if (first)
-                first = false;
-            else
+            // values copied from a column need the source table filled
+            if (gs->valueType == GeneratorSettings::vtColumn)
             {
-                ins += ", ";
-                params += ",";
+                std::map<wxString, size_t>::iterator src =
+                    jobIndex.find(gs->sourceTable);
+                if (src != jobIndex.end())
+                    job.dependsOn.push_back((*src).second);
             }
-            ins += (*col)->getQuotedName();
-            params += "?";
-            colSet.push_back(gs);
         }
-        if (first)  // no columns
+        if (job.columnNames.empty())  // no columns
             continue;
 
-        IBPP::Statement st =
-            IBPP::StatementFactory(databaseM->getIBPPDatabase(), tr);
-        st->Prepare(wx2std(ins + params + ")"));
+        std::vector<ForeignKey> *fk = (*it)->getForeignKeys();
+        for (std::vector<ForeignKey>::iterator fi = fk->begin();
+            fi != fk->end(); ++fi)
+        {
+            Identifier id((*fi).getReferencedTable());
+            std::map<wxString, size_t>::iterator ref =
+                jobIndex.find(id.getQuoted());
+            if (ref != jobIndex.end())
+                job.dependsOn.push_back((*ref).second);
+        }
+
+        jobIndex[job.tableName] = jobs.size();
+        jobs.push_back(job);
+        totalRecords += job.records;
+    }
+
+    ProgressDialog pd(this, _("Generating data"), 2);
+    pd.doShow();
+
+    int parallelTables = config().get("DataGeneratorParallelTables", 1);
+    if (parallelTables > 1 && jobs.size() > 1)
+        generateParallel(jobs, parallelTables, totalRecords, pd);
+    else
+        generateSequential(jobs, pd);
+
+    int committed = 0;
+    for (std::vector<DataGeneratorJob>::iterator it = jobs.begin();
+        it != jobs.end(); ++it)
+    {
+        committed += (*it).committed;
+        report += "\n" + wxString::Format(
+            _("%s: %d records in %.1f seconds"), (*it).tableName,
+            (*it).committed, (*it).milliseconds / 1000.0);
+    }
+    return committed;
+}
 
-        for (int i = 0; i < records; i++)
+void DataGeneratorFrame::generateSequential(
+    std::vector<DataGeneratorJob>& jobs, ProgressDialog& pd)
+{
+    pd.initProgress(_("Inserting into tables"), jobs.size());
+
+    // one big transaction, unless a commit interval is configured
+    IBPP::Database db = databaseM->getIBPPDatabase();
+    IBPP::Transaction tr = IBPP::TransactionFactory(db);
+    tr->Start();
+
+    for (std::vector<DataGeneratorJob>::iterator it = jobs.begin();
+        it != jobs.end(); ++it)
+    {
+        pd.setProgressMessage((*it).tableName, 1);
+        pd.stepProgress();
+        pd.initProgress(wxString::Format(_("Inserting %d records."),
+            (*it).records), (*it).records, 0, 2);
+
+        wxStopWatch sw;
+        bool done = insertRecords(*it, db, tr,
+            [&pd](int records)
+            {
+                pd.setProgressPosition(records, 2);
+                return !pd.isCanceled();
+            });
+        (*it).milliseconds = sw.Time();
+        if (!done)
+            return;
+    }
+
+    tr->Commit();
+    for (std::vector<DataGeneratorJob>::iterator it = jobs.begin();
+        it != jobs.end(); ++it)
+    {
+        (*it).committed = (*it).inserted;
+    }
+}
+
+void DataGeneratorFrame::generateParallel(
+    std::vector<DataGeneratorJob>& jobs, int parallelTables,
+    int totalRecords, ProgressDialog& pd)
+{
+    pd.initProgress(_("Inserting into tables"), jobs.size());
+    pd.initProgress(wxString::Format(_("Inserting %d records."),
+        totalRecords), totalRecords, 0, 2);
+
+    size_t workerCount = std::min(jobs.size(), size_t(parallelTables));
+    // the attachments are created here, as the worker threads must not
+    // access the database object
+    std::vector<IBPP::Database> attachments;
+    for (size_t i = 0; i < workerCount; ++i)
+        attachments.push_back(databaseM->createAttachment());
+
+    // 0 = waiting, 1 = running, 2 = done
+    std::vector<int> states(jobs.size(), 0);
+    size_t jobsDone = 0;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;
+    std::atomic<bool> stop(false);
+    std::atomic<int> recordsDone(0);
+    std::atomic<size_t> workersRunning(workerCount);
+
+    // returns the index of a waiting job whose dependencies are done, or
+    // jobs.size() if there is none
+    auto findReadyJob = [&]()
+    {
+        for (size_t i = 0; i < jobs.size(); ++i)
         {
-            if (pd.isCanceled())
-                return;
-            pd.stepProgress(1, 2);
-            for (int p = 0; p < st->Parameters(); ++p)
-                setParam(st, p+1, colSet[p], i);
+            if (states[i] != 0)
+                continue;
+            bool ready = true;
+            for (size_t d = 0; ready && d < jobs[i].dependsOn.size(); ++d)
+                ready = states[jobs[i].dependsOn[d]] == 2;
+            if (ready)
+                return i;
+        }
+        return jobs.size();
+    };
+
+    // every worker uses its own attachment, and one transaction per table
+    // that is committed when the table is done, so the tables depending on
+    // it can be filled
+    auto worker = [&](IBPP::Database& attachment)
+    {
+        try
+        {
+            attachment->Connect();
+            while (true)
+            {
+                size_t index = jobs.size();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]()
+                    {
+                        index = findReadyJob();
+                        return stop || jobsDone == jobs.size()
+                            || index < jobs.size();
+                    });
+                    if (stop || index == jobs.size())
+                        break;
+                    states[index] = 1;
+                }
+
+                DataGeneratorJob& job = jobs[index];
+                IBPP::Transaction tr = IBPP::TransactionFactory(attachment);
+                tr->Start();
+                wxStopWatch sw;
+                int reported = 0;
+                bool done = insertRecords(job, attachment, tr,
+                    [&](int records)
+                    {
+                        recordsDone += records - reported;
+                        reported = records;
+                        return !stop;
+                    });
+                if (done)
+                {
+                    tr->Commit();
+                    job.committed = job.inserted;
+                }
+                else
+                    tr->Rollback();
+                job.milliseconds = sw.Time();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                states[index] = 2;
+                ++jobsDone;
+                changed.notify_all();
+            }
+            attachment->Disconnect();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+            stop = true;
+            changed.notify_all();
+        }
+        --workersRunning;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workerCount; ++i)
+        threads.push_back(std::thread(worker, std::ref(attachments[i])));
+
+    // the worker threads must not touch the dialog, so it is updated here
+    while (workersRunning > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pd.setProgressPosition(jobsDone, 1);
+        }
+        pd.setProgressPosition(recordsDone, 2);
+        if (!stop && pd.isCanceled())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            changed.notify_all();
+        }
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool DataGeneratorFrame::insertRecords(DataGeneratorJob& job,
+    IBPP::Database db, IBPP::Transaction tr,
+    std::function<bool(int)> progress)
+{
+    // create insert statement
+    wxString ins = "INSERT INTO " + job.tableName + " (";
+    wxString params(") VALUES (");
+    for (size_t c = 0; c < job.columnNames.size(); ++c)
+    {
+        if (c)
+        {
+            ins += ", ";
+            params += ",";
+        }
+        ins += job.columnNames[c];
+        params += "?";
+    }
+
+    IBPP::Statement st = IBPP::StatementFactory(db, tr);
+    st->Prepare(wx2std(ins + params + ")"));
+    int colCount = st->Parameters();
+    std::vector<GeneratorSettings *>& colSet = job.settings;
+
+    // values from files and other tables are read only once
+    std::vector<std::unique_ptr<GeneratorValueProvider> > providers;
+    for (int p = 0; p < colCount; ++p)
+    {
+        providers.push_back(std::unique_ptr<GeneratorValueProvider>(
+            createValueProvider(st, p+1, colSet[p])));
+    }
+
+    // insert several records with one EXECUTE BLOCK statement, the
+    // remaining ones are inserted with the single record statement
+    int records = job.records;
+    IBPP::Statement block;
+    int blockSize = std::min(std::min(job.blockRecords, records),
+        maxBlockParameters / colCount);
+    if (blockSize > 1)
+    {
+        block = prepareInsertBlock(db, tr, job, blockSize);
+        if (block.intf() == 0)
+            blockSize = 1;
+    }
+    else
+        blockSize = 1;
+
+    wxStopWatch sw;
+    long lastUpdate = 0;
+    int uncommitted = 0;
+    for (int i = 0; i < records; )
+    {
+        if (blockSize > 1 && records - i >= blockSize)
+        {
+            for (int r = 0; r < blockSize; ++r)
+            {
+                for (int p = 0; p < colCount; ++p)
+                {
+                    setParam(block, r * colCount + p + 1, colSet[p],
+                        providers[p].get(), i + r);
+                }
+            }
+            block->Execute();
+            i += blockSize;
+            uncommitted += blockSize;
+        }
+        else
+        {
+            for (int p = 0; p < colCount; ++p)
+                setParam(st, p+1, colSet[p], providers[p].get(), i);
             st->Execute();
+            ++i;
+            ++uncommitted;
+        }
+        job.inserted = i;
+
+        if (job.commitInterval > 0 && uncommitted >= job.commitInterval)
+        {
+            tr->Commit();
+            tr->Start();
+            job.committed = i;
+            uncommitted = 0;
+        }
+
+        // reporting the progress for every record costs more than
+        // inserting it, so do it only a few times a second
+        if (sw.Time() - lastUpdate >= 100 || i == records)
+        {
+            lastUpdate = sw.Time();
+            if (!progress(i))
+                return false;
         }
     }
+    return true;
+}
 
-    tr->Commit();
+IBPP::Statement DataGeneratorFrame::prepareInsertBlock(IBPP::Database db,
+    IBPP::Transaction tr, const DataGeneratorJob& job, int records)
+{
+    const std::vector<wxString>& columns = job.columnNames;
+    wxString sql("EXECUTE BLOCK (");
+    for (int r = 0; r < records; ++r)
+    {
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            if (r || c)
+                sql += ", ";
+            sql += wxString::Format("P%d_%d TYPE OF COLUMN ", r, (int)c)
+                + job.tableName + "." + columns[c] + " = ?";
+        }
+    }
+    sql += ")\nAS\nBEGIN\n";
+    for (int r = 0; r < records; ++r)
+    {
+        sql += "  INSERT INTO " + job.tableName + " (";
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            if (c)
+                sql += ", ";
+            sql += columns[c];
+        }
+        sql += ") VALUES (";
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            if (c)
+                sql += ", ";
+            sql += wxString::Format(":P%d_%d", r, (int)c);
+        }
+        sql += ");\n";
+    }
+    sql += "END";
+
+    IBPP::Statement st = IBPP::StatementFactory(db, tr);
+    try
+    {
+        st->Prepare(wx2std(sql));
+    }
+    catch (IBPP::Exception&)
+    {
+        // too long or too big input message for this server, the caller
+        // falls back to inserting the records one at a time
+        return IBPP::Statement();
+    }
+    return st;
 }
 
@@ -27,7 +27,10 @@
 #include <wx/spinctrl.h>
 #include <wx/splitter.h>
 
+#include <functional>
+#include <list>
 #include <map>
+#include <vector>
 
 #include <ibpp.h>
 
@@ -40,6 +43,9 @@ class Column;
 class Table;
 class DBHTreeControl;
 class GeneratorSettings;
+class GeneratorValueProvider;
+struct DataGeneratorJob;
+class ProgressDialog;
 
 class DataGeneratorFrame: public BaseFrame, public Observer
 {
@@ -57,10 +63,23 @@ protected:
     void loadSetting(wxTreeItemId newitem);
     bool loadColumns(const wxString& tableName, wxChoice* c);
     bool sortTables(std::list<Table *>& order);
-    void generateData(std::list<Table *>& order);
+    // returns the number of committed records, report gets a line with
+    // the number of records and the time for every table
+    int generateData(std::list<Table *>& order, wxString& report);
+    void generateSequential(std::vector<DataGeneratorJob>& jobs,
+        ProgressDialog& pd);
+    void generateParallel(std::vector<DataGeneratorJob>& jobs,
+        int parallelTables, int totalRecords, ProgressDialog& pd);
+    // returns false if canceled by the progress callback
+    bool insertRecords(DataGeneratorJob& job, IBPP::Database db,
+        IBPP::Transaction tr, std::function<bool(int)> progress);
+    // upper limit of parameters for one EXECUTE BLOCK statement
+    enum { maxBlockParameters = 1000 };
+    IBPP::Statement prepareInsertBlock(IBPP::Database db,
+        IBPP::Transaction tr, const DataGeneratorJob& job, int records);
 
-    void setParam( IBPP::Statement st, int param, GeneratorSettings* gs,
-        int recNo);
+    void setParam(IBPP::Statement st, int param, GeneratorSettings* gs,
+        GeneratorValueProvider* provider, int recNo);
     void setString(IBPP::Statement st, int param, GeneratorSettings* gs,
         int recNo);
 
@@ -813,6 +813,7 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
     gridMenu->AppendSeparator();
     gridMenu->Append(Cmds::DataGrid_Save_as_html,    _("Save as &html"));
     gridMenu->Append(Cmds::DataGrid_Save_as_csv,     _("Save as cs&v"));
+    gridMenu->Append(Cmds::DataGrid_Export_all,      _("&Export all records..."));
     gridMenu->AppendSeparator();
     gridMenu->AppendCheckItem(Cmds::DataGrid_Log_changes, _("&Log data changes"));
     menuBarM->Append(gridMenu, _("&Grid"));
@@ -935,6 +936,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_STC_UPDATEUI(ExecuteSqlFrame::ID_stc_sql, ExecuteSqlFrame::OnSqlEditUpdateUI)
     EVT_STC_CHARADDED(ExecuteSqlFrame::ID_stc_sql, ExecuteSqlFrame::OnSqlEditCharAdded)
     EVT_STC_CHANGE(ExecuteSqlFrame::ID_stc_sql, ExecuteSqlFrame::OnSqlEditChanged)
+    EVT_STC_MODIFIED(ExecuteSqlFrame::ID_stc_sql, ExecuteSqlFrame::OnSqlEditModified)
     EVT_STC_START_DRAG(ExecuteSqlFrame::ID_stc_sql, ExecuteSqlFrame::OnSqlEditStartDrag)
     EVT_SPLITTER_UNSPLIT(wxID_ANY, ExecuteSqlFrame::OnSplitterUnsplit)
     EVT_CHAR_HOOK(ExecuteSqlFrame::OnKeyDown)
@@ -1016,6 +1018,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_MENU(Cmds::DataGrid_ExportBlob,      ExecuteSqlFrame::OnMenuGridExportBlob)
     EVT_MENU(Cmds::DataGrid_Save_as_html,    ExecuteSqlFrame::OnMenuGridSaveAsHtml)
     EVT_MENU(Cmds::DataGrid_Save_as_csv,     ExecuteSqlFrame::OnMenuGridSaveAsCsv)
+    EVT_MENU(Cmds::DataGrid_Export_all,      ExecuteSqlFrame::OnMenuGridExportAll)
     EVT_MENU(Cmds::DataGrid_FetchAll,        ExecuteSqlFrame::OnMenuGridFetchAll)
     EVT_MENU(Cmds::DataGrid_CancelFetchAll,  ExecuteSqlFrame::OnMenuGridCancelFetchAll)
 
@@ -1030,6 +1033,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_UPDATE_UI(Cmds::DataGrid_ExportBlob,     ExecuteSqlFrame::OnMenuUpdateGridCellIsBlob)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_html,   ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_csv,    ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
+    EVT_UPDATE_UI(Cmds::DataGrid_Export_all,     ExecuteSqlFrame::OnMenuUpdateGridExportAll)
     EVT_UPDATE_UI(Cmds::DataGrid_FetchAll,       ExecuteSqlFrame::OnMenuUpdateGridFetchAll)
     EVT_UPDATE_UI(Cmds::DataGrid_CancelFetchAll, ExecuteSqlFrame::OnMenuUpdateGridCancelFetchAll)
 
@@ -1243,6 +1247,24 @@ void ExecuteSqlFrame::OnSqlEditChanged(wxStyledTextEvent& WXUNUSED(event))
     updateFrameTitleM = true;
 }
 
+void ExecuteSqlFrame::OnSqlEditModified(wxStyledTextEvent& event)
+{
+    event.Skip();
+    int type = event.GetModificationType();
+    if ((type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT)) == 0)
+        return;
+
+    // Scintilla reports byte positions, the statement index works with
+    // characters like the wxString of the editor text
+    int position = styled_text_ctrl_sql->CountCharacters(0,
+        event.GetPosition());
+    int length = event.GetText().length();
+    if (type & wxSTC_MOD_INSERTTEXT)
+        statementIndexM.textInserted(position, length);
+    else
+        statementIndexM.textDeleted(position, length);
+}
+
 void ExecuteSqlFrame::autoCompleteColumns(int pos, int len)
 {
     int start;
@@ -1261,7 +1283,8 @@ void ExecuteSqlFrame::autoCompleteColumns(int pos, int len)
             return;
     }
     wxString table = styled_text_ctrl_sql->GetTextRange(start, pos-1);
-    IncompleteStatement is(databaseM, styled_text_ctrl_sql->GetText());
+    IncompleteStatement is(databaseM, styled_text_ctrl_sql->GetText(),
+        &statementIndexM);
     wxString columns = is.getObjectColumns(table, pos, len>0 || config().get("autoCompleteLoadColumnsSort", false));//When the user are typing something, you need to sort de result, else intelisense won't work properly
     if (columns.IsEmpty())
         return;
@@ -2021,6 +2044,28 @@ void ExecuteSqlFrame::OnMenuGridSaveAsHtml(wxCommandEvent& WXUNUSED(event))
     grid_data->saveAsHTML();
 }
 
+// reads the CSV delimiter settings of the save_as_csv and export_data
+// templates
+static bool getCSVDelimiters(Config& conf, wxChar& fieldDelimiter,
+    wxChar& textDelimiter)
+{
+    int i;
+    if (!conf.getValue("CSVFieldDelimiter", i))
+        return false;
+    static const wxChar fieldDelimiters[] = { '\t', ',', ';' };
+    if (i < 0 || i >= sizeof(fieldDelimiters) / sizeof(wxChar))
+        return false;
+    fieldDelimiter = fieldDelimiters[i];
+
+    if (!conf.getValue("CSVTextDelimiter", i))
+        return false;
+    static const wxChar textDelimiters[] = { '\0', '"', '\'' };
+    if (i < 0 || i >= sizeof(textDelimiters) / sizeof(wxChar))
+        return false;
+    textDelimiter = textDelimiters[i];
+    return true;
+}
+
 void ExecuteSqlFrame::OnMenuGridSaveAsCsv(wxCommandEvent& WXUNUSED(event))
 {
     CodeTemplateProcessor ctp(0, this);
@@ -2032,22 +2077,55 @@ void ExecuteSqlFrame::OnMenuGridSaveAsCsv(wxCommandEvent& WXUNUSED(event))
     if (!ctp.getConfig().getValue("CSVExportFileName", fileName))
         return;
 
-    int i;
-    if (!ctp.getConfig().getValue("CSVFieldDelimiter", i))
+    wxChar fieldDelimiter, textDelimiter;
+    if (!getCSVDelimiters(ctp.getConfig(), fieldDelimiter, textDelimiter))
         return;
-    static const wxChar fieldDelimiters[] = { '\t', ',', ';' };
-    if (i < 0 || i >= sizeof(fieldDelimiters) / sizeof(wxChar))
+
+    grid_data->saveAsCSV(fileName, fieldDelimiter, textDelimiter);
+}
+
+void ExecuteSqlFrame::OnMenuGridExportAll(wxCommandEvent& WXUNUSED(event))
+{
+    DataGridTable* table = grid_data->getDataGridTable();
+    if (!table)
         return;
-    wxChar fieldDelimiter(fieldDelimiters[i]);
 
-    if (!ctp.getConfig().getValue("CSVTextDelimiter", i))
+    CodeTemplateProcessor ctp(0, this);
+    wxString code;
+    ctp.processTemplateFile(code,
+        config().getSysTemplateFileName("export_data"), 0);
+
+    wxString fileName;
+    if (!ctp.getConfig().getValue("ExportFileName", fileName)
+        || fileName.empty())
+    {
         return;
-    static const wxChar textDelimiters[] = { '\0', '"', '\'' };
-    if (i < 0 || i >= sizeof(textDelimiters) / sizeof(wxChar))
+    }
+
+    int i;
+    if (!ctp.getConfig().getValue("ExportFormat", i))
         return;
-    wxChar textDelimiter(textDelimiters[i]);
+    if (i < defCSV || i > defColumnar)
+        return;
+    DataGridExportFormat format = DataGridExportFormat(i);
 
-    grid_data->saveAsCSV(fileName, fieldDelimiter, textDelimiter);
+    wxChar fieldDelimiter, textDelimiter;
+    if (!getCSVDelimiters(ctp.getConfig(), fieldDelimiter, textDelimiter))
+        return;
+
+    unsigned fetched = table->GetNumberRows();
+    ProgressDialog pd(this, _("Exporting records"));
+    pd.doShow();
+    unsigned exported = table->exportAllRows(fileName, format,
+        fieldDelimiter, textDelimiter, &pd);
+    log(wxString::Format(_("%u records exported to %s."), exported,
+        fileName.c_str()));
+    if (exported > fetched)
+    {
+        log(_("The grid only shows the records fetched before the export."));
+        statusbar_1->SetStatusText(wxString::Format(
+            _("%u rows exported"), exported), 1);
+    }
 }
 
 
@@ -2063,6 +2141,12 @@ void ExecuteSqlFrame::OnMenuUpdateGridFetchAll(wxUpdateUIEvent& event)
         && !table->getFetchAllRows());
 }
 
+void ExecuteSqlFrame::OnMenuUpdateGridExportAll(wxUpdateUIEvent& event)
+{
+    event.Enable(grid_data->getDataGridTable()
+        && grid_data->GetNumberCols() > 0);
+}
+
 void ExecuteSqlFrame::OnMenuUpdateGridCancelFetchAll(wxUpdateUIEvent& event)
 {
     DataGridTable* table = grid_data->getDataGridTable();
@@ -2344,52 +2428,86 @@ void ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible(wxUpdateUIEvent& event)
 void ExecuteSqlFrame::compareCounts(IBPP::DatabaseCounts& one,
     IBPP::DatabaseCounts& two)
 {
+    struct RelationCounts
+    {
+        wxString name;
+        int values[5];
+    };
+    std::vector<RelationCounts> rows;
+    size_t nameWidth = 0;
+
     for (IBPP::DatabaseCounts::iterator it = two.begin(); it != two.end();
         ++it)
     {
-        wxString str_log;
         IBPP::DatabaseCounts::iterator i2 = one.find((*it).first);
         IBPP::CountInfo c;
         IBPP::CountInfo& r1 = (*it).second;
         IBPP::CountInfo& r2 = c;
         if (i2 != one.end())
             r2 = (*i2).second;
-        if (r1.inserts > r2.inserts)
-            str_log += wxString::Format(_("%d inserts. "), r1.inserts - r2.inserts);
-        if (r1.updates > r2.updates)
-            str_log += wxString::Format(_("%d updates. "), r1.updates - r2.updates);
-        if (r1.deletes > r2.deletes)
-            str_log += wxString::Format(_("%d deletes. "), r1.deletes - r2.deletes);
-        if (r1.readIndex > r2.readIndex)
-            str_log += wxString::Format(_("%d reads index. "), r1.readIndex - r2.readIndex);
-        if (r1.readSequence > r2.readSequence)
-            str_log += wxString::Format(_("%d reads sequence. "), r1.readSequence - r2.readSequence);
-        if (!str_log.IsEmpty())
+
+        RelationCounts row;
+        row.values[0] = r1.inserts - r2.inserts;
+        row.values[1] = r1.updates - r2.updates;
+        row.values[2] = r1.deletes - r2.deletes;
+        row.values[3] = r1.readIndex - r2.readIndex;
+        row.values[4] = r1.readSequence - r2.readSequence;
+        bool changed = false;
+        for (int i = 0; i < 5; ++i)
         {
-            wxString relName;
-            try
-            {
-                IBPP::Statement st = IBPP::StatementFactory(
-                    databaseM->getIBPPDatabase(), transactionM);
-                st->Prepare(
-                    "select rdb$relation_name "
-                    "from rdb$relations where rdb$relation_id = ?");
-                st->Set(1, (*it).first);
-                st->Execute();
-                if (st->Fetch())
-                {
-                    std::string s;
-                    st->Get(1, s);
-                    relName = std2wxIdentifier(s, databaseM->getCharsetConverter());
-                }
-            }
-            catch (...)
-            {
-            }
-            if (relName.IsEmpty())
-                relName.Format(_("Relation #%d"), (*it).first);
-            log(relName + ": " + str_log, ttSql);
+            if (row.values[i] > 0)
+                changed = true;
+            else
+                row.values[i] = 0;
+        }
+        if (!changed)
+            continue;
+
+        try
+        {
+            // the names are cached by the database
+            row.name = databaseM->getRelationName((*it).first);
+        }
+        catch (...)
+        {
+        }
+        if (row.name.IsEmpty())
+            row.name = wxString::Format(_("Relation #%d"), (*it).first);
+        nameWidth = std::max(nameWidth, row.name.length());
+        rows.push_back(row);
+    }
+    if (rows.empty())
+        return;
+
+    // log one line per relation, with the counters in aligned columns
+    const wxString headers[6] = { _("Relation"), _("Inserts"), _("Updates"),
+        _("Deletes"), _("Index reads"), _("Seq. reads") };
+    const size_t valueWidth = 12;
+    nameWidth = std::max(nameWidth, headers[0].length());
+
+    wxString header(headers[0]);
+    header.Pad(nameWidth - headers[0].length());
+    for (int i = 1; i < 6; ++i)
+    {
+        header += wxString(' ', valueWidth > headers[i].length()
+            ? valueWidth - headers[i].length() : 1);
+        header += headers[i];
+    }
+    log(header, ttSql);
+
+    for (std::vector<RelationCounts>::iterator it = rows.begin();
+        it != rows.end(); ++it)
+    {
+        wxString line((*it).name);
+        line.Pad(nameWidth - (*it).name.length());
+        for (int i = 0; i < 5; ++i)
+        {
+            wxString value(wxString::Format("%d", (*it).values[i]));
+            size_t width = std::max(valueWidth, headers[i + 1].length() + 1);
+            line += wxString(' ', width - value.length());
+            line += value;
         }
+        log(line, ttSql);
     }
 }
 
@@ -2797,6 +2915,8 @@ bool ExecuteSqlFrame::commitTransaction()
         sae.scroll();
         {
             wxStopWatch sw;
+            // stop fetching in background before the cursor is closed
+            grid_data->cancelFetchAll();
             statementM->Close();
             transactionM->Commit();
             log(wxString::Format(_("Transaction committed (elapsed time: %s)."),
@@ -2818,12 +2938,8 @@ bool ExecuteSqlFrame::commitTransaction()
             }
         }
 
-        // parse all successfully executed statements
-        for (std::vector<SqlStatement>::const_iterator it =
-            executedStatementsM.begin(); it != executedStatementsM.end(); ++it)
-        {
-            databaseM->parseCommitedSql(*it);
-        }
+        // parse all successfully executed statements at once
+        databaseM->parseCommitedSql(executedStatementsM);
 
         // possible future version (see database.cpp file for details: ONLY IF FIRST solution is used from database.cpp)
         //for (std::vector<wxString>::const_iterator it = executedStatementsM.begin(); it != executedStatementsM.end(); ++it)
@@ -2892,6 +3008,8 @@ bool ExecuteSqlFrame::rollbackTransaction()
         sae.scroll();
         {
             wxStopWatch sw;
+            // stop fetching in background before the cursor is closed
+            grid_data->cancelFetchAll();
             statementM->Close();
             transactionM->Rollback();
             log(wxString::Format(_("Transaction rolled back (elapsed time: %s)."),
@@ -40,6 +40,7 @@
 #include "gui/BaseFrame.h"
 #include "gui/EditBlobDialog.h"
 #include "gui/FindDialog.h"
+#include "sql/MultiStatement.h"
 #include "sql/SqlStatement.h"
 #include "statementHistory.h"
 #include "map"
@@ -146,6 +147,7 @@ private:
     void OnSqlEditUpdateUI(wxStyledTextEvent& event);
     void OnSqlEditCharAdded(wxStyledTextEvent& event);      // autocomplete stuff
     void OnSqlEditChanged(wxStyledTextEvent& event);        // update title
+    void OnSqlEditModified(wxStyledTextEvent& event);       // statement index
     void OnSqlEditStartDrag(wxStyledTextEvent& event);      // enable click&remove selection
     wxString keywordsM;     // text used for autocomplete
     void setKeywords();
@@ -163,6 +165,9 @@ private:
     bool updateFrameTitleM;
     void updateFrameTitle();
 
+    // statements of the editor text for autocompletion, updated on demand
+    StatementIndex statementIndexM;
+
     // blob-editor-timer
     enum {
         TIMER_ID_UPDATE_BLOB = 1
@@ -255,11 +260,13 @@ private:
     void OnMenuGridCopyAsUpdateInsert(wxCommandEvent& event);
     void OnMenuGridSaveAsHtml(wxCommandEvent& event);
     void OnMenuGridSaveAsCsv(wxCommandEvent& event);
+    void OnMenuGridExportAll(wxCommandEvent& event);
     void OnMenuGridFetchAll(wxCommandEvent& event);
     void OnMenuGridCancelFetchAll(wxCommandEvent& event);
     void OnMenuUpdateGridHasSelection(wxUpdateUIEvent& event);
     void OnMenuUpdateGridHasData(wxUpdateUIEvent& event);
     void OnMenuUpdateGridFetchAll(wxUpdateUIEvent& event);
+    void OnMenuUpdateGridExportAll(wxUpdateUIEvent& event);
     void OnMenuUpdateGridCancelFetchAll(wxUpdateUIEvent& event);
     void OnMenuUpdateGridCanSetFieldToNULL(wxUpdateUIEvent& event);
 
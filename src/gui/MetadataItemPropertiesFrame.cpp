@@ -59,8 +59,9 @@
 class MetadataItemPropertiesPanel: public wxPanel, public Observer
 {
 private:
-    enum { ptSummary, ptConstraints, ptDependencies, ptTriggers,
-        ptTableIndices, ptDDL, ptPrivileges } pageTypeM;
+    enum PageType { ptSummary, ptConstraints, ptDependencies, ptTriggers,
+        ptTableIndices, ptDDL, ptPrivileges };
+    PageType pageTypeM;
 
     MetadataItem* objectM;
     bool htmlReloadRequestedM;
@@ -69,6 +70,8 @@ private:
     // load page in idle handler, only request a reload in update()
     void requestLoadPage(bool showLoadingPage);
     void loadPage();
+    void processPage(wxString& htmlpage);
+    void renderPage(const wxString& htmlpage);
 
     // observer stuff
     virtual void subjectRemoved(Subject* subject);
@@ -161,8 +164,16 @@ void MetadataItemPropertiesPanel::requestLoadPage(bool showLoadingPage)
     }
 }
 
-//! determine the path, load and display html page
+//! process the template and display the html page
 void MetadataItemPropertiesPanel::loadPage()
+{
+    wxString htmlpage;
+    processPage(htmlpage);
+    renderPage(htmlpage);
+}
+
+//! determine the path and process the template, loading all metadata used
+void MetadataItemPropertiesPanel::processPage(wxString& htmlpage)
 {
     wxString fileName = config().getHtmlTemplatesPath();
     switch (pageTypeM)
@@ -200,12 +211,13 @@ void MetadataItemPropertiesPanel::loadPage()
     ProgressDialog pd(this, _("Processing template..."));
     pd.doShow();
 
-    wxString htmlpage;
     HtmlTemplateProcessor tp(objectM, this);
     tp.processTemplateFile(htmlpage, fileName, 0, &pd);
+}
 
-    pd.SetTitle(_("Rendering page..."));
-
+//! display the processed page
+void MetadataItemPropertiesPanel::renderPage(const wxString& htmlpage)
+{
     wxWindowUpdateLocker freeze(html_window);
     int x = 0, y = 0;
     html_window->GetViewStart(&x, &y);         // save scroll position
@@ -31,6 +31,7 @@
 #endif
 
 #include <algorithm>
+#include <list>
 #include <vector>
 
 #include <wx/artprov.h>
@@ -778,6 +779,13 @@ public:
     virtual void handleTemplateCmd(TemplateProcessor *tp,
         const wxString& cmdName, const TemplateCmdParams& cmdParams,
         ProcessableObject* object, wxString& processedText);
+    virtual wxArrayString getCommandNames() const
+    {
+        wxArrayString names;
+        names.Add("edit_conf");
+        names.Add("edit_info");
+        return names;
+    }
 };
 
 const PreferencesDialogTemplateCmdHandler PreferencesDialogTemplateCmdHandler::handlerInstance;
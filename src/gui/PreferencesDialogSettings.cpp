@@ -46,6 +46,7 @@
 #include <vector>
 
 #include <functional>
+#include <list>
 
 #include "config/Config.h"
 #include "frutils.h"
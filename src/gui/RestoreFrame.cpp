@@ -34,6 +34,7 @@
 #include <wx/filename.h>
 
 #include <algorithm>
+#include <list>
 
 #include <ibpp.h>
 
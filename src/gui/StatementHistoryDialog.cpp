@@ -206,33 +206,36 @@ void StatementHistoryDialog::OnButtonSearchClick(wxCommandEvent&
 
     // start the search
     listbox_search->Clear();
-    wxString searchString = textctrl_search->GetValue().Upper();
     setSearching(true);
-    StatementHistory::Position total = historyM->size();
+    std::vector<StatementHistory::Position> found;
+    {
+        wxBusyCursor wait;
+        found = historyM->search(textctrl_search->GetValue());
+    }
+    size_t total = found.size();
     gauge_progress->SetRange((int)total);
     wxString last = wxEmptyString;
-    for (StatementHistory::Position p = total - 1; (int)p >= 0; --p)
+    for (size_t i = 0; i < total; ++i)
     {
-        wxYield();
+        if (i % 100 == 0)
+            wxYield();
         if (!isSearchingM)
         {
             gauge_progress->SetValue(0);
             return;
         }
 
-        gauge_progress->SetValue((int)(total - p - 1));
+        gauge_progress->SetValue((int)i);
+        StatementHistory::Position p = found[i];
         wxString s(historyM->get(p));
         if (s == last)  // ignore duplicates
             continue;
         last = s;
-        if (searchString.IsEmpty() || s.Upper().Contains(searchString))
-        {
-            wxString entry;
-            entry = (s.Length() > 200) ? s.Mid(0, 200) + "..." : s;
-            entry.Replace("\n", " ");
-            entry.Replace("\r", wxEmptyString);
-            listbox_search->Append(entry, (void *)p);
-        }
+        wxString entry;
+        entry = (s.Length() > 200) ? s.Mid(0, 200) + "..." : s;
+        entry.Replace("\n", " ");
+        entry.Replace("\r", wxEmptyString);
+        listbox_search->Append(entry, (void *)p);
     }
     setSearching(false);
     gauge_progress->SetValue(0);
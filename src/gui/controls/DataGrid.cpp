@@ -38,6 +38,8 @@
 #include <wx/wfstream.h>
 #include <wx/intl.h>
 
+#include <algorithm>
+
 #include "config/Config.h"
 #include "config/LocalSettings.h"
 #include "core/FRError.h"
@@ -51,7 +53,8 @@
 #include "metadata/table.h"
 
 DataGrid::DataGrid(wxWindow* parent, wxWindowID id)
-    : wxGrid(parent, id), timerM(this, TIMER_ID), calculateSumM(true)
+    : wxGrid(parent, id), timerM(this, TIMER_ID), aggregateRangeIndexM(0),
+        aggregateRowM(0), aggregateTableM(0), aggregateRestartM(true)
 {
     // this is necessary for wxWidgets 3.0, otherwise grid will be as wide
     // as the sum of column widths
@@ -199,6 +202,7 @@ void DataGrid::showPopupMenu(wxPoint cursorPos)
     m.Append(Cmds::DataGrid_Copy_as_inList, _("Copy as IN list"));
     m.Append(Cmds::DataGrid_Save_as_html, _("Save as HTML file..."));
     m.Append(Cmds::DataGrid_Save_as_csv, _("Save as CSV file..."));
+    m.Append(Cmds::DataGrid_Export_all, _("Export all records to file..."));
     m.AppendSeparator();
 
     m.Append(Cmds::DataGrid_EditBlob, _("Edit BLOB..."));
@@ -980,75 +984,162 @@ BEGIN_EVENT_TABLE(DataGrid, wxGrid)
 #endif
 END_EVENT_TABLE()
 
-void DataGrid::OnGridCellSelected(wxGridEvent& event)
+void DataGrid::startAggregation()
 {
+    aggregateRestartM = true;
     timerM.Start(500, wxTIMER_ONE_SHOT);
+}
+
+void DataGrid::OnGridCellSelected(wxGridEvent& event)
+{
+    startAggregation();
     event.Skip();
 }
 
 void DataGrid::OnGridRangeSelected(wxGridRangeSelectEvent& event)
 {
-    timerM.Start(500, wxTIMER_ONE_SHOT);
+    startAggregation();
     event.Skip();
 }
 
-DEFINE_EVENT_TYPE(wxEVT_FRDG_SUM)
-void DataGrid::OnTimer(wxTimerEvent& WXUNUSED(event))
+void DataGrid::collectAggregateRanges(DataGridTable* table)
 {
-    // calculate sum for all selected fields and show in status bar
-    DataGridTable* table = getDataGridTable();
-    if (!table || !calculateSumM)
+    aggregateRangesM.clear();
+    const int rows = GetNumberRows();
+    const int cols = GetNumberCols();
+    if (rows <= 0 || cols <= 0)
         return;
 
-    double sum = 0;
-    bool any = false;
-    bool alert = true;
-    wxStopWatch sw;;
-    for (int j = 0; j < GetNumberCols(); j++)
+    // row ranges of every numeric column, from all kinds of selections
+    std::vector<std::vector<std::pair<int, int> > > ranges(cols);
+    std::vector<bool> numeric(cols);
+    for (int c = 0; c < cols; c++)
+        numeric[c] = table->isNumericColumn(c);
+
+    wxArrayInt selRows(GetSelectedRows());
+    for (size_t i = 0; i < selRows.size(); i++)
     {
-        if (!table->isNumericColumn(j))
-            continue;
-        for (int i = 0; i < GetNumberRows(); i++)
+        for (int c = 0; c < cols; c++)
         {
-            if (IsInSelection(i, j))
+            if (numeric[c])
+                ranges[c].push_back(std::make_pair(selRows[i], selRows[i]));
+        }
+    }
+    wxArrayInt selCols(GetSelectedCols());
+    for (size_t i = 0; i < selCols.size(); i++)
+    {
+        if (selCols[i] < cols && numeric[selCols[i]])
+            ranges[selCols[i]].push_back(std::make_pair(0, rows - 1));
+    }
+    wxGridCellCoordsArray blocksTL(GetSelectionBlockTopLeft());
+    wxGridCellCoordsArray blocksBR(GetSelectionBlockBottomRight());
+    for (size_t i = 0; i < blocksTL.size(); i++)
+    {
+        const wxGridCellCoords& tl = blocksTL[i];
+        const wxGridCellCoords& br = blocksBR[i];
+        for (int c = tl.GetCol(); c <= br.GetCol() && c < cols; c++)
+        {
+            if (numeric[c])
             {
-                double d;
-                wxString val = table->getCellValue(i, j);
-                if (val.ToDouble(&d))
-                {
-                    sum += d;
-                    any = true;
-                }
+                ranges[c].push_back(std::make_pair(tl.GetRow(),
+                    br.GetRow()));
             }
-            if (alert && sw.Time() > 4000)
+        }
+    }
+    wxGridCellCoordsArray cells(GetSelectedCells());
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        const wxGridCellCoords& cc = cells[i];
+        if (cc.GetCol() < cols && numeric[cc.GetCol()])
+        {
+            ranges[cc.GetCol()].push_back(std::make_pair(cc.GetRow(),
+                cc.GetRow()));
+        }
+    }
+
+    // merge overlapping ranges, every cell is counted only once
+    for (int c = 0; c < cols; c++)
+    {
+        std::vector<std::pair<int, int> >& colRanges = ranges[c];
+        std::sort(colRanges.begin(), colRanges.end());
+        for (size_t i = 0; i < colRanges.size(); i++)
+        {
+            AggregateRange r = { c, colRanges[i].first, colRanges[i].second };
+            if (!aggregateRangesM.empty() && aggregateRangesM.back().col == c
+                && r.firstRow <= aggregateRangesM.back().lastRow + 1)
             {
-                AdvancedMessageDialogButtonsYesNoCancel amb(_("&Abort"),
-                    _("&Disable for this grid"), _("&Continue"));
-                int res = showQuestionDialog(this,
-                    _("Calculating the sum takes too long"),
-                    _("FlameRobin automatically calculates the sum of selected numeric values. However, the current calculation seems to be taking too long. Would you like to abort it?"),
-                    amb, config(), "DIALOG_DisableGridSum",
-                    _("Do not ask this question again"));
-                if (res == wxNO)
-                    calculateSumM = false;
-                if (res == wxYES || res == wxNO)
-                    return;
-                alert = false;
+                aggregateRangesM.back().lastRow = std::max(r.lastRow,
+                    aggregateRangesM.back().lastRow);
             }
+            else
+                aggregateRangesM.push_back(r);
+        }
+    }
+}
+
+DEFINE_EVENT_TYPE(wxEVT_FRDG_SUM)
+// formats value without trailing zeroes
+static wxString formatAggregate(double value)
+{
+    wxString s = wxString::Format("%f", value);
+    s.Truncate(1 + s.find_last_not_of("0"));
+    s.Truncate(1 + s.find_last_not_of("."));
+    return s;
+}
+
+void DataGrid::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+    // calculate aggregates for all selected fields and show in status bar
+    DataGridTable* table = getDataGridTable();
+    if (!table)
+        return;
+
+    if (aggregateRestartM || table != aggregateTableM)
+    {
+        aggregateRestartM = false;
+        aggregateTableM = table;
+        collectAggregateRanges(table);
+        aggregateRangeIndexM = 0;
+        aggregateRowM = aggregateRangesM.empty() ? 0
+            : aggregateRangesM[0].firstRow;
+        aggregatesM.reset(new DataGridAggregates());
+    }
+
+    // work in time slices of 50 ms, the timer resumes the calculation
+    const int rowsPerStep = 10000;
+    wxStopWatch sw;
+    while (aggregateRangeIndexM < aggregateRangesM.size())
+    {
+        const AggregateRange& r = aggregateRangesM[aggregateRangeIndexM];
+        int lastRow = std::min(r.lastRow, aggregateRowM + rowsPerStep - 1);
+        table->aggregateColumn(r.col, aggregateRowM, lastRow, *aggregatesM);
+        aggregateRowM = lastRow + 1;
+        if (aggregateRowM > r.lastRow)
+        {
+            if (++aggregateRangeIndexM < aggregateRangesM.size())
+                aggregateRowM = aggregateRangesM[aggregateRangeIndexM].firstRow;
+        }
+        if (aggregateRangeIndexM < aggregateRangesM.size() && sw.Time() > 50)
+        {
+            timerM.Start(1, wxTIMER_ONE_SHOT);
+            return;
         }
     }
 
-    if (any)
+    if (aggregatesM->count > 0)
     {
+        const DataGridAggregates& ag = *aggregatesM;
         // used in frame to update status bar
         wxCommandEvent evt(wxEVT_FRDG_SUM, GetId());
-        wxString ss = wxString::Format("Sum: %f", sum);
-        // strip trailing zeroes
-        ss.Truncate(1 + ss.find_last_not_of("0"));
-        ss.Truncate(1 + ss.find_last_not_of("."));
-        evt.SetString(ss);
+        evt.SetString(wxString::Format(
+            _("Sum: %s  Avg: %s  Min: %s  Max: %s  Count: %lu  Distinct: %lu"),
+            formatAggregate(ag.sum), formatAggregate(ag.sum / ag.count),
+            formatAggregate(ag.min), formatAggregate(ag.max),
+            (unsigned long)ag.count, (unsigned long)ag.distinct.size()));
         wxPostEvent(this, evt);
     }
+    // the values aren't needed anymore
+    aggregatesM->distinct.clear();
 }
 
 void DataGrid::OnEditorCreated(wxGridEditorCreatedEvent& event)
@@ -1129,10 +1220,11 @@ void DataGrid::OnIdle(wxIdleEvent& event)
     }
     // fetch more rows until row cache is filled or timeslice is spent, and
     // request another wxEVT_IDLE event if row cache has not been filled
+    // (the background fetch thread wakes us up itself when rows are ready)
     if (table->needsMoreRowsFetched())
     {
         table->fetch();
-        if (table->needsMoreRowsFetched())
+        if (table->needsMoreRowsFetched() && !table->isFetchingInBackground())
             event.RequestMore();
         AdjustScrollbars();
     }
@@ -28,9 +28,11 @@
 #include <wx/grid.h>
 #include <wx/listimpl.cpp>
 
+#include <memory>
 #include <vector>
 
 class DataGridTable;
+struct DataGridAggregates;
 
 BEGIN_DECLARE_EVENT_TYPES()
     // this event is sent when selection is changed and values are summed up
@@ -42,7 +44,23 @@ class DataGrid: public wxGrid
 private:
     wxTimer timerM;
     enum { TIMER_ID = 3333 };
-    bool calculateSumM;
+
+    // the selected cells of numeric columns are aggregated in slices
+    // on timer events, so large selections don't block the GUI
+    struct AggregateRange
+    {
+        int col;
+        int firstRow;
+        int lastRow;
+    };
+    std::vector<AggregateRange> aggregateRangesM;
+    size_t aggregateRangeIndexM;
+    int aggregateRowM;
+    std::unique_ptr<DataGridAggregates> aggregatesM;
+    DataGridTable* aggregateTableM;
+    bool aggregateRestartM;
+    void collectAggregateRanges(DataGridTable* table);
+    void startAggregation();
 
     void copyToClipboard(const wxString cbText);
     void extendSelection(int direction);
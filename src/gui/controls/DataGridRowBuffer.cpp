@@ -30,6 +30,8 @@
     #include "wx/wx.h"
 #endif
 
+#include <cstring>
+
 #include "gui/controls/DataGridRowBuffer.h"
 
 // Time + timestamp internal struct
@@ -43,24 +45,86 @@ union TimeZoneBufferValue
     } s;
 };
 
+DataGridRowArena::DataGridRowArena()
+    : currentChunkM(0), chunkUsedM(0), allocatedM(0)
+{
+}
+
+uint8_t* DataGridRowArena::allocate(size_t size, size_t align)
+{
+    // large blocks get a chunk of their own, the current chunk stays usable
+    if (size > chunkSize / 4)
+    {
+        chunksM.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[size]()));
+        allocatedM += size;
+        return chunksM.back().get();
+    }
+    // align must be a power of two
+    size_t start = (chunkUsedM + align - 1) & ~(align - 1);
+    if (!currentChunkM || start + size > chunkSize)
+    {
+        chunksM.push_back(
+            std::unique_ptr<uint8_t[]>(new uint8_t[chunkSize]()));
+        currentChunkM = chunksM.back().get();
+        start = 0;
+        allocatedM += chunkSize;
+    }
+    chunkUsedM = start + size;
+    return currentChunkM + start;
+}
+
+void DataGridRowArena::clear()
+{
+    chunksM.clear();
+    currentChunkM = 0;
+    chunkUsedM = 0;
+    allocatedM = 0;
+}
+
+size_t DataGridRowArena::getAllocatedBytes() const
+{
+    return allocatedM;
+}
+
 DataGridRowBuffer::DataGridRowBuffer(unsigned fieldCount)
+    : fieldCountM(fieldCount), dataSizeM(0)
 {
     isModifiedM = 0;
     isDeletedM = 0;
     isDeletableIsSetM = 0;
     isDeletableM = 0;
-    // initialize with field count, all fields initially NULL
-    // there's no need to preallocate the uint8 buffer or string array
-    DataGridRowBufferFieldAttr initValue;
-    initValue.isStringLoaded = false;
-    initValue.isNull = true;
-    fieldAttrM.resize(fieldCount, initValue);
+    // there's no need to preallocate the data buffer or string array
+    ownsStorageM = 1;
+    storageM = new uint8_t[getDataStart(fieldCount)]();
+    // all fields initially NULL
+    for (unsigned i = 0; i < fieldCountM; ++i)
+        getFieldAttr(i)->isNull = true;
+}
+
+DataGridRowBuffer::DataGridRowBuffer(unsigned fieldCount, unsigned dataSize,
+        DataGridRowArena& arena)
+    : fieldCountM(fieldCount), dataSizeM(dataSize)
+{
+    isModifiedM = 0;
+    isDeletedM = 0;
+    isDeletableIsSetM = 0;
+    isDeletableM = 0;
+    // field attributes and data of all fields in one block of the arena
+    ownsStorageM = 0;
+    storageM = arena.allocate(getDataStart(fieldCount) + dataSize);
+    // all fields initially NULL
+    for (unsigned i = 0; i < fieldCountM; ++i)
+        getFieldAttr(i)->isNull = true;
 }
 
 DataGridRowBuffer::DataGridRowBuffer(const DataGridRowBuffer* other)
+    : fieldCountM(other->fieldCountM), dataSizeM(other->dataSizeM)
 {
-    fieldAttrM = other->fieldAttrM;
-    dataM = other->dataM;
+    // copies always own their storage
+    unsigned size = getDataStart(fieldCountM) + dataSizeM;
+    ownsStorageM = 1;
+    storageM = new uint8_t[size];
+    memcpy(storageM, other->storageM, size);
     stringsM = other->stringsM;
     blobsM = other->blobsM;
 
@@ -70,6 +134,50 @@ DataGridRowBuffer::DataGridRowBuffer(const DataGridRowBuffer* other)
     isDeletableM = other->isDeletableM;
 }
 
+DataGridRowBuffer::~DataGridRowBuffer()
+{
+    if (ownsStorageM)
+        delete[] storageM;
+}
+
+unsigned DataGridRowBuffer::getDataStart(unsigned fieldCount)
+{
+    // keep the field data 8-byte aligned
+    unsigned size = fieldCount * sizeof(DataGridRowBufferFieldAttr);
+    return (size + 7) & ~7u;
+}
+
+DataGridRowBufferFieldAttr* DataGridRowBuffer::getFieldAttr(unsigned num)
+{
+    return reinterpret_cast<DataGridRowBufferFieldAttr*>(storageM) + num;
+}
+
+uint8_t* DataGridRowBuffer::getData(unsigned offset, unsigned size)
+{
+    if (offset + size > dataSizeM)
+        return 0;
+    return storageM + getDataStart(fieldCountM) + offset;
+}
+
+uint8_t* DataGridRowBuffer::prepareData(unsigned offset, unsigned size)
+{
+    if (offset + size > dataSizeM)
+    {
+        // rows from an arena have all their data preallocated, so this
+        // is normally only needed for inserted rows, but moving the data
+        // into own storage works for all of them
+        unsigned dataStart = getDataStart(fieldCountM);
+        uint8_t* storage = new uint8_t[dataStart + offset + size]();
+        memcpy(storage, storageM, dataStart + dataSizeM);
+        if (ownsStorageM)
+            delete[] storageM;
+        storageM = storage;
+        ownsStorageM = 1;
+        dataSizeM = offset + size;
+    }
+    return storageM + getDataStart(fieldCountM) + offset;
+}
+
 wxString DataGridRowBuffer::getString(unsigned index)
 {
     if (index >= stringsM.size())
@@ -86,66 +194,83 @@ IBPP::Blob* DataGridRowBuffer::getBlob(unsigned index)
 
 bool DataGridRowBuffer::getValue(unsigned offset, double& value)
 {
-    if (offset + sizeof(double) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(double));
+    if (!data)
         return false;
-    value = *((double*)&dataM[offset]);
+    value = *((double*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, float& value)
 {
-    if (offset + sizeof(float) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(float));
+    if (!data)
         return false;
-    value = *((float*)&dataM[offset]);
+    value = *((float*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, dec16_t& value)
 {
-    if (offset + sizeof(dec16_t) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(dec16_t));
+    if (!data)
         return false;
-    value = *((dec16_t*)&dataM[offset]);
+    value = *((dec16_t*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, dec34_t& value)
 {
-    if (offset + sizeof(dec34_t) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(dec34_t));
+    if (!data)
         return false;
-    value = *((dec34_t*)&dataM[offset]);
+    value = *((dec34_t*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, int& value)
 {
-    if (offset + sizeof(int) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(int));
+    if (!data)
         return false;
-    value = *((int*)&dataM[offset]);
+    value = *((int*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, int64_t& value)
 {
-    if (offset + sizeof(int64_t) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(int64_t));
+    if (!data)
         return false;
-    value = *((int64_t*)&dataM[offset]);
+    value = *((int64_t*)data);
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, int128_t& value)
 {
-    if (offset + sizeof(int128_t) > dataM.size())
+    uint8_t* data = getData(offset, sizeof(int128_t));
+    if (!data)
         return false;
-    value = *((int128_t*)&dataM[offset]);
+    memcpy(&value, data, sizeof(int128_t));
     return true;
 }
 
 bool DataGridRowBuffer::getValue(unsigned offset, IBPP::DBKey& value,
     unsigned size)
 {
-    if (offset + size > dataM.size())
+    uint8_t* data = getData(offset, size);
+    if (!data)
+        return false;
+    value.SetKey(data, size);
+    return true;
+}
+
+bool DataGridRowBuffer::getValue(unsigned offset, DataGridRawString& value)
+{
+    uint8_t* data = getData(offset, sizeof(DataGridRawString));
+    if (!data)
         return false;
-    value.SetKey(&dataM[offset], size);
+    memcpy(&value, data, sizeof(DataGridRawString));
     return true;
 }
 
@@ -172,28 +297,28 @@ void DataGridRowBuffer::setFieldNA(unsigned /* num */, bool /* isNA */)
 
 bool DataGridRowBuffer::isFieldNull(unsigned num)
 {
-    return (num < fieldAttrM.size() && fieldAttrM[num].isNull);
+    return (num < fieldCountM && getFieldAttr(num)->isNull);
 }
 
 void DataGridRowBuffer::setFieldNull(unsigned num, bool isNull)
 {
-    if (num < fieldAttrM.size())
+    if (num < fieldCountM)
     {
-        fieldAttrM[num].isNull = isNull;
+        getFieldAttr(num)->isNull = isNull;
         invalidateIsDeletable();
     }
 }
 
 bool DataGridRowBuffer::isStringLoaded(unsigned num)
 {
-    return (num < fieldAttrM.size() && fieldAttrM[num].isStringLoaded);
+    return (num < fieldCountM && getFieldAttr(num)->isStringLoaded);
 }
 
 void DataGridRowBuffer::setStringLoaded(unsigned num, bool isLoaded)
 {
-    if (num < fieldAttrM.size())
+    if (num < fieldCountM)
     {
-        fieldAttrM[num].isStringLoaded = isLoaded;
+        getFieldAttr(num)->isStringLoaded = isLoaded;
         invalidateIsDeletable();
     }
 }
@@ -203,7 +328,7 @@ void DataGridRowBuffer::setString(unsigned num, const wxString& value)
     if (num >= stringsM.size())
         stringsM.resize(num + 1, wxEmptyString);
     stringsM[num] = value;
-    fieldAttrM[num].isStringLoaded = true;
+    getFieldAttr(num)->isStringLoaded = true;
     invalidateIsDeletable();
 }
 
@@ -217,65 +342,58 @@ void DataGridRowBuffer::setBlob(unsigned num, IBPP::Blob value)
 
 void DataGridRowBuffer::setValue(unsigned offset, double value)
 {
-    if (offset + sizeof(double) > dataM.size())
-        dataM.resize(offset + sizeof(double), 0);
-    *((double*)&dataM[offset]) = value;
+    *((double*)prepareData(offset, sizeof(double))) = value;
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, float value)
 {
-    if (offset + sizeof(float) > dataM.size())
-        dataM.resize(offset + sizeof(float), 0);
-    *((float*)&dataM[offset]) = value;
+    *((float*)prepareData(offset, sizeof(float))) = value;
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, dec16_t value)
 {
-    if (offset + sizeof(dec16_t) > dataM.size())
-        dataM.resize(offset + sizeof(dec16_t), 0);
-    *((dec16_t*)&dataM[offset]) = value;
+    *((dec16_t*)prepareData(offset, sizeof(dec16_t))) = value;
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, dec34_t value)
 {
-    if (offset + sizeof(dec34_t) > dataM.size())
-        dataM.resize(offset + sizeof(dec34_t), 0);
-    *((dec34_t*)&dataM[offset]) = value;
+    *((dec34_t*)prepareData(offset, sizeof(dec34_t))) = value;
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, int value)
 {
-    if (offset + sizeof(int) > dataM.size())
-        dataM.resize(offset + sizeof(int), 0);
-    *((int*)&dataM[offset]) = value;
+    *((int*)prepareData(offset, sizeof(int))) = value;
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, int64_t value)
 {
-    if (offset + sizeof(int64_t) > dataM.size())
-        dataM.resize(offset + sizeof(int64_t), 0);
-    *((int64_t*)&dataM[offset]) = value;
+    *((int64_t*)prepareData(offset, sizeof(int64_t))) = value;
     invalidateIsDeletable();
 }
 
 void  DataGridRowBuffer::setValue(unsigned offset, int128_t value)
 {
-    if (offset + sizeof(int128_t) > dataM.size())
-        dataM.resize(offset + sizeof(int128_t), 0);
-    *((int128_t*)&dataM[offset]) = value;
+    // field offsets are not aligned to 16 bytes
+    memcpy(prepareData(offset, sizeof(int128_t)), &value, sizeof(int128_t));
     invalidateIsDeletable();
 }
 
 void DataGridRowBuffer::setValue(unsigned offset, IBPP::DBKey value)
 {
-    if (offset + value.Size() > dataM.size())
-        dataM.resize(offset + value.Size(), 0);
-    value.GetKey(&dataM[offset], value.Size());
+    value.GetKey(prepareData(offset, value.Size()), value.Size());
+    invalidateIsDeletable();
+}
+
+void DataGridRowBuffer::setValue(unsigned offset,
+    const DataGridRawString& value)
+{
+    memcpy(prepareData(offset, sizeof(DataGridRawString)), &value,
+        sizeof(DataGridRawString));
     invalidateIsDeletable();
 }
 
@@ -24,6 +24,9 @@
 #ifndef FR_DATAGRIDROWBUFFER_H
 #define FR_DATAGRIDROWBUFFER_H
 
+#include <memory>
+#include <vector>
+
 #include <ibpp.h>
 #include <core/FRInt128.h>
 #include <core/FRDecimal.h>
@@ -41,6 +44,33 @@ struct DataGridRowBufferFieldAttr
     bool isStringLoaded:1;  // accessed by stringIndexM !!
 };
 
+// DataGridRowArena: chunked memory for the field data of fetched rows.
+// Saves the separate heap allocations for every row, memory is released
+// only as a whole when the result set is cleared.
+class DataGridRowArena
+{
+private:
+    enum { chunkSize = 256 * 1024, alignment = 16 };
+    std::vector<std::unique_ptr<uint8_t[]> > chunksM;
+    uint8_t* currentChunkM;
+    size_t chunkUsedM;
+    size_t allocatedM;
+public:
+    DataGridRowArena();
+
+    // returns zero-initialized memory
+    uint8_t* allocate(size_t size, size_t align = alignment);
+    void clear();
+    size_t getAllocatedBytes() const;
+};
+
+// undecoded CHAR / VARCHAR data of a fetched field, zero-terminated
+struct DataGridRawString
+{
+    const char* data;
+    unsigned length;
+};
+
 // DataGridRowBuffer class
 class DataGridRowBuffer
 {
@@ -50,17 +80,34 @@ private:
     bool isDeletedM:1;
     bool isDeletableIsSetM:1;
     bool isDeletableM:1;
+    // storage is either taken from a DataGridRowArena (fetched rows) or
+    // allocated and owned by the buffer (copies and inserted rows)
+    bool ownsStorageM:1;
+
+    unsigned fieldCountM;
+    unsigned dataSizeM;
+    // one block with field attributes first, followed by field data
+    uint8_t* storageM;
+
+    // not copyable, use the constructor taking a pointer instead
+    DataGridRowBuffer(const DataGridRowBuffer& other);
+    DataGridRowBuffer& operator=(const DataGridRowBuffer& other);
+
+    static unsigned getDataStart(unsigned fieldCount);
+    DataGridRowBufferFieldAttr* getFieldAttr(unsigned num);
+    uint8_t* getData(unsigned offset, unsigned size);
+    uint8_t* prepareData(unsigned offset, unsigned size);
 protected:
-    std::vector<DataGridRowBufferFieldAttr> fieldAttrM;
-    std::vector<uint8_t> dataM;
     std::vector<wxString> stringsM;
     std::vector<IBPP::Blob> blobsM;
     void invalidateIsDeletable();
     void setIsModified(bool value);
 public:
     DataGridRowBuffer(unsigned fieldCount);
+    DataGridRowBuffer(unsigned fieldCount, unsigned dataSize,
+        DataGridRowArena& arena);
     DataGridRowBuffer(const DataGridRowBuffer* other);
-    virtual ~DataGridRowBuffer() {}
+    virtual ~DataGridRowBuffer();
 
     wxString getString(unsigned index);
     IBPP::Blob *getBlob(unsigned index);
@@ -72,6 +119,7 @@ public:
     bool getValue(unsigned offset, int64_t& value);
     bool getValue(unsigned offset, int128_t& value);
     bool getValue(unsigned offset, IBPP::DBKey& value, unsigned size);
+    bool getValue(unsigned offset, DataGridRawString& value);
     bool getValue32(unsigned offset, int& timeZone, bool& isGmtFallback);
     bool isFieldNull(unsigned num);
     void setFieldNull(unsigned num, bool isNull);
@@ -89,6 +137,7 @@ public:
     void setValue(unsigned offset, int64_t value);
     void setValue(unsigned offset, int128_t value);
     void setValue(unsigned offset, IBPP::DBKey value);
+    void setValue(unsigned offset, const DataGridRawString& value);
     void setValue32(unsigned offset, int timeZone, bool isGmtFallback);
 
     virtual bool isInserted();
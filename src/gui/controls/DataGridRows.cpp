@@ -37,7 +37,10 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
+#include <list>
 #include <string>
+#include <unordered_map>
 
 #include "config/LocalSettings.h"
 #include "core/FRError.h"
@@ -76,6 +79,39 @@ void GridCellFormats::loadFromConfig()
         wxString("D.N.Y H:M:S.T"));
     showTimezoneInfoM = (ShowTimezoneInfoType)config().get("ShowTimezoneInfo", int(tzName));
 
+    static const DateTimeFormat::FieldDef dateDefs[] = {
+        { 'd', DateTimeFormat::ffDay, 1 }, { 'D', DateTimeFormat::ffDay, 2 },
+        { 'm', DateTimeFormat::ffMonth, 1 },
+        { 'M', DateTimeFormat::ffMonth, 2 },
+        { 'y', DateTimeFormat::ffYear2, 2 }, { 'Y', DateTimeFormat::ffYear, 4 },
+        { 0, DateTimeFormat::ffText, 0 }
+    };
+    static const DateTimeFormat::FieldDef timeDefs[] = {
+        { 'h', DateTimeFormat::ffHour, 1 }, { 'H', DateTimeFormat::ffHour, 2 },
+        { 'm', DateTimeFormat::ffMinute, 1 },
+        { 'M', DateTimeFormat::ffMinute, 2 },
+        { 's', DateTimeFormat::ffSecond, 1 },
+        { 'S', DateTimeFormat::ffSecond, 2 },
+        { 'T', DateTimeFormat::ffMilliseconds, 3 },
+        { 0, DateTimeFormat::ffText, 0 }
+    };
+    static const DateTimeFormat::FieldDef timestampDefs[] = {
+        { 'd', DateTimeFormat::ffDay, 1 }, { 'D', DateTimeFormat::ffDay, 2 },
+        { 'n', DateTimeFormat::ffMonth, 1 },
+        { 'N', DateTimeFormat::ffMonth, 2 },
+        { 'y', DateTimeFormat::ffYear2, 2 }, { 'Y', DateTimeFormat::ffYear, 4 },
+        { 'h', DateTimeFormat::ffHour, 1 }, { 'H', DateTimeFormat::ffHour, 2 },
+        { 'm', DateTimeFormat::ffMinute, 1 },
+        { 'M', DateTimeFormat::ffMinute, 2 },
+        { 's', DateTimeFormat::ffSecond, 1 },
+        { 'S', DateTimeFormat::ffSecond, 2 },
+        { 'T', DateTimeFormat::ffMilliseconds, 3 },
+        { 0, DateTimeFormat::ffText, 0 }
+    };
+    compiledDateFormatM.compile(dateFormatM, dateDefs);
+    compiledTimeFormatM.compile(timeFormatM, timeDefs);
+    compiledTimestampFormatM.compile(timestampFormatM, timestampDefs);
+
     maxBlobKBytesM = config().get("DataGridFetchBlobAmount", 1);
     showBinaryBlobContentM = config().get("GridShowBinaryBlobs", false);
     showBlobContentM = config().get("DataGridFetchBlobs", true);
@@ -95,36 +131,12 @@ wxString GridCellFormats::formatDate(int year, int month, int day)
 {
     ensureCacheValid();
 
-    wxString result;
-    for (wxString::const_iterator c = dateFormatM.begin();
-        c != dateFormatM.end(); c++)
-    {
-        switch (wxChar(*c))
-        {
-            case 'd':
-                result += wxString::Format("%d", day);
-                break;
-            case 'D':
-                result += wxString::Format("%02d", day);
-                break;
-            case 'm':
-                result += wxString::Format("%d", month);
-                break;
-            case 'M':
-                result += wxString::Format("%02d", month);
-                break;
-            case 'y':
-                result += wxString::Format("%02d", year % 100);
-                break;
-            case 'Y':
-                result += wxString::Format("%04d", year);
-                break;
-            default:
-                result += *c;
-                break;
-        }
-    }
-    return result;
+    int values[DateTimeFormat::ffCount] = { 0 };
+    values[DateTimeFormat::ffDay] = day;
+    values[DateTimeFormat::ffMonth] = month;
+    values[DateTimeFormat::ffYear] = year;
+    values[DateTimeFormat::ffYear2] = year % 100;
+    return compiledDateFormatM.format(values);
 }
 
 bool getNumber(wxString::iterator& ci, wxString::iterator& end, int& toSet)
@@ -214,38 +226,12 @@ wxString GridCellFormats::formatTime(IBPP::Time &t, bool hasTz, Database* db)
     int hour, minute, second, tenththousands;
     t.GetTime(hour, minute, second, tenththousands);
 
-    wxString result;
-    for (wxString::iterator c = timeFormatM.begin(); c != timeFormatM.end();
-        c++)
-    {
-        switch ((wxChar)*c)
-        {
-            case 'h':
-                result += wxString::Format("%d", hour);
-                break;
-            case 'H':
-                result += wxString::Format("%02d", hour);
-                break;
-            case 'm':
-                result += wxString::Format("%d", minute);
-                break;
-            case 'M':
-                result += wxString::Format("%02d", minute);
-                break;
-            case 's':
-                result += wxString::Format("%d", second);
-                break;
-            case 'S':
-                result += wxString::Format("%02d", second);
-                break;
-            case 'T':
-                result += wxString::Format("%03d", tenththousands / 10);
-                break;
-            default:
-                result += *c;
-                break;
-        }
-    }
+    int values[DateTimeFormat::ffCount] = { 0 };
+    values[DateTimeFormat::ffHour] = hour;
+    values[DateTimeFormat::ffMinute] = minute;
+    values[DateTimeFormat::ffSecond] = second;
+    values[DateTimeFormat::ffMilliseconds] = tenththousands / 10;
+    wxString result(compiledTimeFormatM.format(values));
     formatAppendTz(result, t, hasTz, db);
     return result;
 }
@@ -304,56 +290,16 @@ wxString GridCellFormats::formatTimestamp(IBPP::Timestamp &ts, bool hasTz,
     ts.GetDate(year, month, day);
     ts.GetTime(hour, minute, second, tenththousands);
 
-    wxString result;
-    for (wxString::iterator c = timestampFormatM.begin();
-        c != timestampFormatM.end(); c++)
-    {
-        switch ((wxChar)*c)
-        {
-            case 'd':
-                result += wxString::Format("%d", day);
-                break;
-            case 'D':
-                result += wxString::Format("%02d", day);
-                break;
-            case 'n':
-                result += wxString::Format("%d", month);
-                break;
-            case 'N':
-                result += wxString::Format("%02d", month);
-                break;
-            case 'y':
-                result += wxString::Format("%02d", year % 100);
-                break;
-            case 'Y':
-                result += wxString::Format("%04d", year);
-                break;
-            case 'h':
-                result += wxString::Format("%d", hour);
-                break;
-            case 'H':
-                result += wxString::Format("%02d", hour);
-                break;
-            case 'm':
-                result += wxString::Format("%d", minute);
-                break;
-            case 'M':
-                result += wxString::Format("%02d", minute);
-                break;
-            case 's':
-                result += wxString::Format("%d", second);
-                break;
-            case 'S':
-                result += wxString::Format("%02d", second);
-                break;
-            case 'T':
-                result += wxString::Format("%03d", tenththousands / 10);
-                break;
-            default:
-                result += *c;
-                break;
-        }
-    }
+    int values[DateTimeFormat::ffCount] = { 0 };
+    values[DateTimeFormat::ffDay] = day;
+    values[DateTimeFormat::ffMonth] = month;
+    values[DateTimeFormat::ffYear] = year;
+    values[DateTimeFormat::ffYear2] = year % 100;
+    values[DateTimeFormat::ffHour] = hour;
+    values[DateTimeFormat::ffMinute] = minute;
+    values[DateTimeFormat::ffSecond] = second;
+    values[DateTimeFormat::ffMilliseconds] = tenththousands / 10;
+    wxString result(compiledTimestampFormatM.format(values));
     formatAppendTz(result, ts, hasTz, db);
 
     return result;
@@ -367,21 +313,23 @@ void GridCellFormats::formatAppendTz(wxString &s, IBPP::Time &t, bool hasTz,
         return;
 
     int timezone = t.GetTimezone();
+    s += " (";
     if (showTimezoneInfoM == tzRawId)
     {
         if (t.IsTimeZoneGmtFallback())
             timezone = 0;
-        s += wxString::Format(" (%05d)", timezone);
+        wxChar buffer[16];
+        s.append(buffer,
+            DateTimeFormat::formatNumber(buffer, timezone, 5) - buffer);
     }
     else
     {
-        wxString tzName;
         if (t.IsTimeZoneGmtFallback())
-            tzName = "GMT*";
+            s += "GMT*";
         else
-            tzName = db->getTimezoneName(timezone);
-        s += wxString::Format(" (%s)", tzName);
+            s += db->getTimezoneName(timezone);
     }
+    s += ")";
 }
 
 bool GridCellFormats::parseTimestamp(wxString::iterator& start,
@@ -500,11 +448,20 @@ wxString ResultsetColumnDef::getName()
     return nameM;
 }
 
+bool ResultsetColumnDef::getAsDouble(DataGridRowBuffer*, double&)
+{
+    return false;
+}
+
 unsigned ResultsetColumnDef::getIndex()
 {
     return 0;
 }
 
+void ResultsetColumnDef::clearCache()
+{
+}
+
 bool ResultsetColumnDef::isNumeric()
 {
     return false;
@@ -567,6 +524,7 @@ public:
     IntegerColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -590,6 +548,16 @@ wxString IntegerColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return wxString::Format("%d", value);
 }
 
+bool IntegerColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    int intValue;
+    if (!buffer->getValue(offsetM, intValue))
+        return false;
+    value = intValue;
+    return true;
+}
+
 void IntegerColumnDef::setFromString(DataGridRowBuffer* buffer,
         const wxString& source)
 {
@@ -628,6 +596,7 @@ public:
     Int64ColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -651,6 +620,16 @@ wxString Int64ColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return wxLongLong(value).ToString();
 }
 
+bool Int64ColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    int64_t intValue;
+    if (!buffer->getValue(offsetM, intValue))
+        return false;
+    value = double(intValue);
+    return true;
+}
+
 void Int64ColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -699,6 +678,7 @@ public:
     Int128ColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -737,6 +717,20 @@ wxString Int128ColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return result;
 }
 
+bool Int128ColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    int128_t intValue;
+    if (!buffer->getValue(offsetM, intValue))
+        return false;
+    // int128_t is a struct for some compilers, so go through the digits
+    if (!Int128ToString(intValue).ToCDouble(&value))
+        return false;
+    for (short i = 0; i < scaleM; ++i)
+        value /= 10;
+    return true;
+}
+
 void Int128ColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -1249,6 +1243,7 @@ public:
     FloatColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1273,6 +1268,16 @@ wxString FloatColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return GridCellFormats::get().format<float>(value);
 }
 
+bool FloatColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    float floatValue;
+    if (!buffer->getValue(offsetM, floatValue))
+        return false;
+    value = floatValue;
+    return true;
+}
+
 void FloatColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -1312,6 +1317,7 @@ public:
     DoubleColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1339,6 +1345,12 @@ wxString DoubleColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return GridCellFormats::get().format<double>(value);
 }
 
+bool DoubleColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    return buffer->getValue(offsetM, value);
+}
+
 void DoubleColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -1377,6 +1389,7 @@ public:
     Dec16ColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1400,6 +1413,16 @@ wxString Dec16ColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return Dec16DPDToString(value);
 }
 
+bool Dec16ColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    dec16_t decValue;
+    if (!buffer->getValue(offsetM, decValue))
+        return false;
+    // the text uses the decimal separator of the locale
+    return Dec16DPDToString(decValue).ToDouble(&value);
+}
+
 void Dec16ColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -1439,6 +1462,7 @@ public:
     Dec34ColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1462,6 +1486,16 @@ wxString Dec34ColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
     return Dec34DPDToString(value);
 }
 
+bool Dec34ColumnDef::getAsDouble(DataGridRowBuffer* buffer, double& value)
+{
+    wxASSERT(buffer);
+    dec34_t decValue;
+    if (!buffer->getValue(offsetM, decValue))
+        return false;
+    // the text uses the decimal separator of the locale
+    return Dec34DPDToString(decValue).ToDouble(&value);
+}
+
 void Dec34ColumnDef::setFromString(DataGridRowBuffer* buffer,
     const wxString& source)
 {
@@ -1624,15 +1658,76 @@ void BlobColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     converterM = db->getCharsetConverter(); // store for later when we fetch the data
 }
 
+// DataGridStringCache class: keeps the most recently decoded string values,
+// which mostly are those of the rows visible in the grid
+class DataGridStringCache
+{
+private:
+    typedef std::pair<const char*, wxString> Entry;
+    // most recently used entry first
+    std::list<Entry> entriesM;
+    std::unordered_map<const char*, std::list<Entry>::iterator> indexM;
+    size_t capacityM;
+public:
+    DataGridStringCache(size_t capacity);
+    bool find(const char* key, wxString& value);
+    void insert(const char* key, const wxString& value);
+    void clear();
+};
+
+DataGridStringCache::DataGridStringCache(size_t capacity)
+    : capacityM(capacity)
+{
+}
+
+bool DataGridStringCache::find(const char* key, wxString& value)
+{
+    std::unordered_map<const char*, std::list<Entry>::iterator>::iterator it
+        = indexM.find(key);
+    if (it == indexM.end())
+        return false;
+    entriesM.splice(entriesM.begin(), entriesM, it->second);
+    value = it->second->second;
+    return true;
+}
+
+void DataGridStringCache::insert(const char* key, const wxString& value)
+{
+    if (entriesM.size() >= capacityM)
+    {
+        indexM.erase(entriesM.back().first);
+        entriesM.pop_back();
+    }
+    entriesM.push_front(Entry(key, value));
+    indexM[key] = entriesM.begin();
+}
+
+void DataGridStringCache::clear()
+{
+    entriesM.clear();
+    indexM.clear();
+}
+
 // StringColumnDef class
 class StringColumnDef : public ResultsetColumnDef
 {
+private:
+    enum { decodedCacheSize = 256 };
 protected:
     unsigned indexM;
+    unsigned offsetM;
     int charSizeM;
+    // fetched values are kept in the connection character set in arenaM,
+    // and are only converted to wxString when they are needed
+    DataGridRowArena* arenaM;
+    wxMBConv* converterM;
+    DataGridStringCache decodedM;
+
+    wxString decode(const char* value, wxMBConv* converter);
 public:
-    StringColumnDef(const wxString& name, unsigned stringIndex, bool readOnly,
-        bool nullable, int charSize);
+    StringColumnDef(const wxString& name, unsigned stringIndex,
+        unsigned offset, bool readOnly, bool nullable, int charSize,
+        DataGridRowArena* arena = 0, wxMBConv* converter = 0);
     virtual unsigned getIndex();
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
@@ -1641,12 +1736,15 @@ public:
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
+    virtual void clearCache();
 };
 
 StringColumnDef::StringColumnDef(const wxString& name, unsigned stringIndex,
-    bool readOnly, bool nullable, int charSize)
+    unsigned offset, bool readOnly, bool nullable, int charSize,
+    DataGridRowArena* arena, wxMBConv* converter)
     : ResultsetColumnDef(name, readOnly, nullable), indexM(stringIndex),
-      charSizeM(charSize)
+      offsetM(offset), charSizeM(charSize), arenaM(arena),
+      converterM(converter), decodedM(decodedCacheSize)
 {
 }
 
@@ -1655,10 +1753,19 @@ unsigned StringColumnDef::getIndex()
     return indexM;
 }
 
+wxString StringColumnDef::decode(const char* value, wxMBConv* converter)
+{
+    wxString val = wxString(value, *converter);
+    size_t trimLen = val.Strip().Length();
+    if (val.Length() > size_t(charSizeM))
+        val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
+    return val;
+}
+
 wxString StringColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
-    wxString s(buffer->getString(indexM));
+    wxString s(getAsString(buffer, 0));
     // SF bug #1889800: quote chars have to be escaped
     s.Replace("'", "''");
     return s;
@@ -1667,7 +1774,22 @@ wxString StringColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 wxString StringColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
 {
     wxASSERT(buffer);
-    return buffer->getString(indexM);
+    // values set by the user are always stored decoded
+    if (!arenaM || buffer->isStringLoaded(indexM))
+        return buffer->getString(indexM);
+
+    DataGridRawString raw;
+    if (!buffer->getValue(offsetM, raw) || !raw.data)
+        return wxEmptyString;
+    // arena memory is not reused until clearRows() clears the cache, so
+    // the address of the raw data identifies the field value
+    wxString value;
+    if (!decodedM.find(raw.data, value))
+    {
+        value = decode(raw.data, converterM);
+        decodedM.insert(raw.data, value);
+    }
+    return value;
 }
 
 void StringColumnDef::setFromString(DataGridRowBuffer* buffer,
@@ -1678,9 +1800,14 @@ void StringColumnDef::setFromString(DataGridRowBuffer* buffer,
     buffer->setString(indexM, source);
 }
 
+void StringColumnDef::clearCache()
+{
+    decodedM.clear();
+}
+
 unsigned StringColumnDef::getBufferSize()
 {
-    return 0;
+    return arenaM ? sizeof(DataGridRawString) : 0;
 }
 
 void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1696,23 +1823,34 @@ void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     }
     else if (statement->ColumnSubtype(col) == 1)   // charset OCTETS
     {
-        std::string value;
-        statement->Get(col, value);
+        const char* text;
+        int length;
+        statement->GetText(col, text, length);
         wxString val;
-        for (std::string::size_type p = 0; p < value.length(); p++)
-            val += wxString::Format("%02x", uint8_t(value[p]));
+        for (int p = 0; p < length; p++)
+            val += wxString::Format("%02x", uint8_t(text[p]));
         buffer->setString(indexM, val);
     }
     else
     {
-        std::string value;
+        // the text is read in place from the fetched row
+        const char* text;
+        int length;
         //wxMBConv* converter = db->getCharsetConverter();
-        statement->Get(col, value);
-        wxString val = wxString(value.c_str(), *converter);
-        size_t trimLen = val.Strip().Length();
-        if (val.Length() > size_t(charSizeM))
-            val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
-        buffer->setString(indexM, val);
+        statement->GetText(col, text, length);
+        // rows inserted by the user may use a different converter
+        if (arenaM && !buffer->isInserted())
+        {
+            char* data = (char*)arenaM->allocate(length + 1, 1);
+            memcpy(data, text, length);
+            data[length] = '\0';
+            DataGridRawString raw;
+            raw.data = data;
+            raw.length = length;
+            buffer->setValue(offsetM, raw);
+        }
+        else
+            buffer->setString(indexM, decode(std::string(text, length).c_str(), converter));
     }
 }
 
@@ -1724,7 +1862,7 @@ public:
 };
 
 BooleanColumnDef::BooleanColumnDef(const wxString& name, unsigned stringIndex,
-    bool readOnly, bool nullable) : StringColumnDef(name, stringIndex, readOnly, nullable, 5)
+    bool readOnly, bool nullable) : StringColumnDef(name, stringIndex, 0, readOnly, nullable, 5)
 {
 }
 
@@ -1761,14 +1899,31 @@ void DataGridRows::addRow(DataGridRowBuffer* buffer)
     buffersM.push_back(buffer);
 }
 
+void DataGridRows::addRows(const std::vector<DataGridRowBuffer*>& buffers)
+{
+    buffersM.reserve(buffersM.size() + buffers.size());
+    buffersM.insert(buffersM.end(), buffers.begin(), buffers.end());
+}
+
 void DataGridRows::addRow(const IBPP::Statement& statement)
 {
-    DataGridRowBuffer* buffer = new DataGridRowBuffer(columnDefsM.size());
+    addRow(createRowBuffer(statement));
+}
+
+// does not touch the row storage, so it may be called from a worker thread
+// while the GUI thread accesses the rows already fetched
+DataGridRowBuffer* DataGridRows::createRowBuffer(
+    const IBPP::Statement& statement)
+{
+    // field data is preallocated in the arena, so no further memory is
+    // needed for anything but strings and blobs
+    DataGridRowBuffer* buffer = new DataGridRowBuffer(columnDefsM.size(),
+        bufferSizeM, arenaM);
     // if anything fails, make sure we release the memory
     try
     {
-        // starts with last column -> with highest buffer offset and
-        // string array index to allocate all needed memory at once
+        // starts with last column -> with highest string array index
+        // to allocate all needed memory at once
         unsigned col = columnDefsM.size();
         do
         {
@@ -1789,7 +1944,7 @@ void DataGridRows::addRow(const IBPP::Statement& statement)
         delete buffer;
         throw;
     }
-    addRow(buffer);
+    return buffer;
 }
 
     void freeBuffer(DataGridRowBuffer* buffer) { delete buffer; }
@@ -1803,6 +1958,8 @@ void DataGridRows::clear()
         for_each(buffersM.begin(), buffersM.end(), freeBuffer);
         buffersM.clear();
     }
+    // only after all buffers using it have been deleted
+    arenaM.clear();
     if (columnDefsM.size())
     {
         for_each(columnDefsM.begin(), columnDefsM.end(), freeColumnDef);
@@ -1814,6 +1971,25 @@ void DataGridRows::clear()
     bufferSizeM = 0;
 }
 
+// deletes all rows but keeps the column definitions, so the object can be
+// filled again from the same statement
+void DataGridRows::clearRows()
+{
+    if (buffersM.size())
+    {
+        for_each(buffersM.begin(), buffersM.end(), freeBuffer);
+        buffersM.clear();
+    }
+    // the decoded values are cached by arena address, and new rows will
+    // most likely be stored at the same addresses
+    for (std::vector<ResultsetColumnDef*>::iterator it = columnDefsM.begin();
+        it != columnDefsM.end(); ++it)
+    {
+        (*it)->clearCache();
+    }
+    arenaM.clear();
+}
+
 bool DataGridRows::canRemoveRow(size_t row)
 {
     if (row >= buffersM.size())
@@ -2145,7 +2321,7 @@ bool DataGridRows::initialize(const IBPP::Statement& statement)
                     int size = statement->ColumnSize(col);
                     if (bpc)
                         size /= bpc;
-                    columnDef = new StringColumnDef(colName, stringIndex, readOnly, nullable, size);
+                    columnDef = new StringColumnDef(colName, stringIndex, bufferSizeM, readOnly, nullable, size, &arenaM, databaseM->getCharsetConverter());
                     ++stringIndex;
                     break;
                 }
@@ -2253,6 +2429,26 @@ wxString DataGridRows::getFieldValue(unsigned row, unsigned col)
     return columnDefsM[col]->getAsString(buffersM[row], databaseM);
 }
 
+void DataGridRows::aggregateColumn(unsigned col, unsigned firstRow,
+    unsigned lastRow, DataGridAggregates& aggregates)
+{
+    if (col >= columnDefsM.size() || !columnDefsM[col]->isNumeric())
+        return;
+    ResultsetColumnDef* columnDef = columnDefsM[col];
+    if (lastRow >= buffersM.size())
+        lastRow = buffersM.size() - 1;
+    for (unsigned row = firstRow; row <= lastRow && row < buffersM.size();
+        ++row)
+    {
+        DataGridRowBuffer* buffer = buffersM[row];
+        if (buffer->isFieldNull(col) || buffer->isFieldNA(col))
+            continue;
+        double value;
+        if (columnDef->getAsDouble(buffer, value))
+            aggregates.add(value);
+    }
+}
+
 bool DataGridRows::isFieldNull(unsigned row, unsigned col)
 {
     if (row >= buffersM.size())
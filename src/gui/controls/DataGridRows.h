@@ -27,14 +27,16 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <unordered_set>
 
 #include <ibpp.h>
 
 #include "metadata/constraints.h"
 #include "config/Config.h"
+#include "core/DateTimeFormat.h"
+#include "gui/controls/DataGridRowBuffer.h"
 
 class Database;
-class DataGridRowBuffer;
 class ProgressIndicator;
 class wxMBConv;
 
@@ -64,6 +66,11 @@ private:
     ShowTimezoneInfoType showTimezoneInfoM;
     void formatAppendTz(wxString &s, IBPP::Time &t, bool hasTz,
         Database* db);
+
+    // the format strings are compiled when the settings are loaded
+    DateTimeFormat compiledDateFormatM;
+    DateTimeFormat compiledTimeFormatM;
+    DateTimeFormat compiledTimestampFormatM;
 protected:
     virtual void loadFromConfig();
 public:
@@ -88,6 +95,28 @@ public:
     bool showBlobContent();
 };
 
+// totals of the numeric values of a set of grid cells
+struct DataGridAggregates
+{
+    size_t count;
+    double sum;
+    double min;
+    double max;
+    std::unordered_set<double> distinct;
+
+    DataGridAggregates() : count(0), sum(0), min(0), max(0) {}
+    void add(double value)
+    {
+        if (count == 0 || value < min)
+            min = value;
+        if (count == 0 || value > max)
+            max = value;
+        sum += value;
+        ++count;
+        distinct.insert(value);
+    }
+};
+
 class ResultsetColumnDef
 {
 private:
@@ -102,11 +131,15 @@ public:
 
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db) = 0;
+    // returns false if the value isn't available as a number
+    virtual bool getAsDouble(DataGridRowBuffer* buffer, double& value);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source) = 0;
     virtual unsigned getBufferSize() = 0;
     wxString getName();
     virtual unsigned getIndex(); // for strings and blobs
+    // drops values cached for rows that are about to be deleted
+    virtual void clearCache();
     virtual bool isNumeric();
     bool isReadOnly();
     bool isNullable();
@@ -141,6 +174,8 @@ private:
     IBPP::Statement statementM;
     std::vector<ResultsetColumnDef*> columnDefsM;
     std::vector<DataGridRowBuffer*> buffersM;
+    // field data of all rows fetched from statementM
+    DataGridRowArena arenaM;
     std::map<wxString, UniqueConstraint *> statementTablesM;
     std::map<wxString, UniqueConstraint *>::iterator deleteFromM;
     std::list<UniqueConstraint> dbKeysM;
@@ -156,6 +191,7 @@ public:
 
     void addRow(const IBPP::Statement& statement);
     void clear();
+    void clearRows();
     unsigned getRowCount();
     unsigned getRowFieldCount();
     wxString getRowFieldName(unsigned col);
@@ -171,6 +207,9 @@ public:
     bool isFieldNA(unsigned row, unsigned col);
 
     wxString getFieldValue(unsigned row, unsigned col);
+    // adds the numeric values of the rows firstRow..lastRow of a column
+    void aggregateColumn(unsigned col, unsigned firstRow, unsigned lastRow,
+        DataGridAggregates& aggregates);
     wxString setFieldValue(unsigned row, unsigned col,
         const wxString& value, bool setNull = false);
     void importBlobFile(const wxString& filename, unsigned row, unsigned col,
@@ -182,6 +221,8 @@ public:
 
     ResultsetColumnDef* getColumnDef(unsigned col);
     void addRow(DataGridRowBuffer* buffer);
+    void addRows(const std::vector<DataGridRowBuffer*>& buffers);
+    DataGridRowBuffer* createRowBuffer(const IBPP::Statement& statement);
 
     // BLOB-Stuff
     IBPP::Blob* getBlob(unsigned row, unsigned col, bool validateBlob);
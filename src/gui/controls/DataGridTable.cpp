@@ -30,14 +30,22 @@
   #include "wx/wx.h"
 #endif
 
+#include <wx/ffile.h>
 #include <wx/grid.h>
+#include <wx/textfile.h>
+#include <wx/thread.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <set>
+#include <string>
 
 #include "config/Config.h"
 #include "core/FRError.h"
+#include "core/ProgressIndicator.h"
 #include "core/StringUtils.h"
+#include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridRows.h"
 #include "gui/controls/DataGridTable.h"
 #include "gui/AdvancedMessageDialog.h"
@@ -46,9 +54,570 @@
 #include "metadata/database.h"
 #include "metadata/table.h"
 
+// DataGridRowBatchQueue: bounded queue of fetched row batches, lock-free
+// because there is exactly one producer (the fetch thread) and exactly one
+// consumer (the GUI thread)
+class DataGridRowBatchQueue
+{
+public:
+    typedef std::vector<DataGridRowBuffer*> Batch;
+private:
+    enum { capacity = 16 };
+    Batch* slotsM[capacity];
+    // both counters only ever grow, they are used modulo capacity
+    std::atomic<unsigned> headM;    // written by consumer only
+    std::atomic<unsigned> tailM;    // written by producer only
+public:
+    DataGridRowBatchQueue();
+
+    bool push(Batch* batch);
+    Batch* pop();
+};
+
+DataGridRowBatchQueue::DataGridRowBatchQueue()
+    : headM(0), tailM(0)
+{
+}
+
+bool DataGridRowBatchQueue::push(Batch* batch)
+{
+    unsigned tail = tailM.load(std::memory_order_relaxed);
+    if (tail - headM.load(std::memory_order_acquire) == capacity)
+        return false;
+    slotsM[tail % capacity] = batch;
+    tailM.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+DataGridRowBatchQueue::Batch* DataGridRowBatchQueue::pop()
+{
+    unsigned head = headM.load(std::memory_order_relaxed);
+    if (head == tailM.load(std::memory_order_acquire))
+        return 0;
+    Batch* batch = slotsM[head % capacity];
+    headM.store(head + 1, std::memory_order_release);
+    return batch;
+}
+
+// DataGridFetchThread: fetches all remaining rows of a result set into row
+// buffers, while running it is the only user of the statement
+class DataGridFetchThread: public wxThread
+{
+private:
+    enum { batchRows = 500, batchMillis = 100 };
+
+    DataGridRows& rowsM;
+    IBPP::Statement statementM;
+    DataGridRowBatchQueue queueM;
+    std::atomic<bool> cancelM;
+    std::atomic<bool> finishedM;
+    // only valid after finishedM has been set
+    DataGridRowBatchQueue::Batch* lastBatchM;
+    bool reachedEndM;
+    wxString errorM;
+
+    bool pushBatch(DataGridRowBatchQueue::Batch* batch);
+protected:
+    virtual ExitCode Entry();
+public:
+    DataGridFetchThread(DataGridRows& rows, IBPP::Statement& statement);
+    ~DataGridFetchThread();
+
+    void cancel();
+    bool isFinished();
+    DataGridRowBatchQueue::Batch* popBatch();
+    bool reachedEnd();
+    wxString getError();
+};
+
+DataGridFetchThread::DataGridFetchThread(DataGridRows& rows,
+        IBPP::Statement& statement)
+    : wxThread(wxTHREAD_JOINABLE), rowsM(rows), statementM(statement),
+        cancelM(false), finishedM(false), lastBatchM(0), reachedEndM(false)
+{
+}
+
+DataGridFetchThread::~DataGridFetchThread()
+{
+    // all batches are normally collected by the GUI thread
+    while (DataGridRowBatchQueue::Batch* batch = popBatch())
+    {
+        std::for_each(batch->begin(), batch->end(),
+            [](DataGridRowBuffer* buffer) { delete buffer; });
+        delete batch;
+    }
+}
+
+bool DataGridFetchThread::pushBatch(DataGridRowBatchQueue::Batch* batch)
+{
+    // wait for the GUI thread to make room, but don't miss cancellation
+    while (!queueM.push(batch))
+    {
+        if (cancelM.load())
+            return false;
+        Sleep(5);
+    }
+    wxWakeUpIdle();
+    return true;
+}
+
+wxThread::ExitCode DataGridFetchThread::Entry()
+{
+    DataGridRowBatchQueue::Batch* batch = 0;
+    try
+    {
+        wxLongLong startms = ::wxGetLocalTimeMillis();
+        while (!cancelM.load())
+        {
+            if (!batch)
+            {
+                batch = new DataGridRowBatchQueue::Batch();
+                batch->reserve(batchRows);
+            }
+            if (!statementM->Fetch())
+            {
+                reachedEndM = true;
+                break;
+            }
+            batch->push_back(rowsM.createRowBuffer(statementM));
+
+            // hand over full batches, and partial ones often enough
+            // to let the grid grow while the user is watching
+            if (batch->size() >= batchRows
+                || ::wxGetLocalTimeMillis() - startms > batchMillis)
+            {
+                if (!pushBatch(batch))
+                    break;
+                batch = 0;
+                startms = ::wxGetLocalTimeMillis();
+            }
+        }
+    }
+    catch (IBPP::Exception& e)
+    {
+        reachedEndM = true;
+        errorM = e.what();
+    }
+    catch (...)
+    {
+        reachedEndM = true;
+        errorM = _("A system error occurred!");
+    }
+    lastBatchM = batch;
+    finishedM.store(true);
+    wxWakeUpIdle();
+    return 0;
+}
+
+void DataGridFetchThread::cancel()
+{
+    cancelM.store(true);
+}
+
+bool DataGridFetchThread::isFinished()
+{
+    return finishedM.load();
+}
+
+DataGridRowBatchQueue::Batch* DataGridFetchThread::popBatch()
+{
+    if (DataGridRowBatchQueue::Batch* batch = queueM.pop())
+        return batch;
+    // the incomplete last batch is never queued, pick it up at the end
+    if (finishedM.load() && lastBatchM)
+    {
+        DataGridRowBatchQueue::Batch* batch = lastBatchM;
+        lastBatchM = 0;
+        return batch;
+    }
+    return 0;
+}
+
+bool DataGridFetchThread::reachedEnd()
+{
+    return finishedM.load() && reachedEndM;
+}
+
+wxString DataGridFetchThread::getError()
+{
+    return finishedM.load() ? errorM : wxString();
+}
+
+// DataGridExportWriter: collects the UTF-8 output of a data export and
+// writes it to the file in large blocks
+class DataGridExportWriter
+{
+private:
+    enum { flushSize = 256 * 1024 };
+
+    wxFFile& fileM;
+    std::string bufferM;
+public:
+    DataGridExportWriter(wxFFile& file);
+
+    void append(char c);
+    void append(const char* data, size_t length);
+    void append(const std::string& s);
+    void append(const wxString& s);
+    void appendUInt32(uint32_t value);
+    void flush();
+};
+
+DataGridExportWriter::DataGridExportWriter(wxFFile& file)
+    : fileM(file)
+{
+    bufferM.reserve(flushSize);
+}
+
+void DataGridExportWriter::append(char c)
+{
+    bufferM += c;
+    if (bufferM.size() >= flushSize)
+        flush();
+}
+
+void DataGridExportWriter::append(const char* data, size_t length)
+{
+    bufferM.append(data, length);
+    if (bufferM.size() >= flushSize)
+        flush();
+}
+
+void DataGridExportWriter::append(const std::string& s)
+{
+    append(s.data(), s.size());
+}
+
+void DataGridExportWriter::append(const wxString& s)
+{
+    wxScopedCharBuffer utf8(s.utf8_str());
+    append(utf8.data(), utf8.length());
+}
+
+void DataGridExportWriter::appendUInt32(uint32_t value)
+{
+    // always little-endian, independent of the platform
+    char bytes[4];
+    for (int i = 0; i < 4; ++i)
+        bytes[i] = char((value >> (8 * i)) & 0xFF);
+    append(bytes, 4);
+}
+
+void DataGridExportWriter::flush()
+{
+    if (bufferM.empty())
+        return;
+    if (fileM.Write(bufferM.data(), bufferM.size()) != bufferM.size())
+        throw FRError(_("Cannot write to destination file."));
+    bufferM.clear();
+}
+
+// DataGridExportFormatter: base class for the export file formats, which
+// turn the rows of a DataGridRows object into the output of a writer
+class DataGridExportFormatter
+{
+protected:
+    DataGridExportWriter& writerM;
+public:
+    DataGridExportFormatter(DataGridExportWriter& writer)
+        : writerM(writer) {}
+    virtual ~DataGridExportFormatter() {}
+
+    virtual void writeHeader(DataGridRows& rows) = 0;
+    virtual void writeRow(DataGridRows& rows, unsigned row) = 0;
+    virtual void writeFooter() {}
+};
+
+// CSV output is identical to what DataGrid::saveAsCSV() writes
+class DataGridCSVExportFormatter: public DataGridExportFormatter
+{
+private:
+    wxString fieldDelimM;
+    wxString textDelimM;
+    wxString eolM;
+public:
+    DataGridCSVExportFormatter(DataGridExportWriter& writer,
+        const wxChar& fieldDelimiter, const wxChar& textDelimiter);
+
+    virtual void writeHeader(DataGridRows& rows);
+    virtual void writeRow(DataGridRows& rows, unsigned row);
+};
+
+DataGridCSVExportFormatter::DataGridCSVExportFormatter(
+        DataGridExportWriter& writer, const wxChar& fieldDelimiter,
+        const wxChar& textDelimiter)
+    : DataGridExportFormatter(writer), fieldDelimM(fieldDelimiter),
+        textDelimM((textDelimiter != '\0') ? wxString(textDelimiter) : ""),
+        eolM(wxTextFile::GetEOL())
+{
+}
+
+void DataGridCSVExportFormatter::writeHeader(DataGridRows& rows)
+{
+    for (unsigned col = 0; col < rows.getRowFieldCount(); ++col)
+    {
+        if (col > 0)
+            writerM.append(fieldDelimM);
+        writerM.append(textDelimM + rows.getRowFieldName(col) + textDelimM);
+    }
+    writerM.append(eolM);
+}
+
+void DataGridCSVExportFormatter::writeRow(DataGridRows& rows, unsigned row)
+{
+    for (unsigned col = 0; col < rows.getRowFieldCount(); ++col)
+    {
+        if (col > 0)
+            writerM.append(fieldDelimM);
+        if (rows.isFieldNA(row, col))
+            continue;
+        if (rows.isFieldNull(row, col))
+        {
+            writerM.append(textDelimM + "NULL" + textDelimM);
+            continue;
+        }
+        wxString s(rows.getFieldValue(row, col));
+        if (!rows.isColumnNumeric(col))
+        {
+            // line breaks in values get the same EOL sequence as rows
+            s.Replace("\r\n", "\n");
+            if (eolM != "\n")
+                s.Replace("\n", eolM);
+            if (!textDelimM.empty())
+            {
+                s.Replace(textDelimM, textDelimM + textDelimM);
+                s = textDelimM + s + textDelimM;
+            }
+        }
+        writerM.append(s);
+    }
+    writerM.append(eolM);
+}
+
+// JSON Lines: one JSON object per row, with the column names as keys
+class DataGridJSONExportFormatter: public DataGridExportFormatter
+{
+private:
+    // the quoted keys including the separators, "," is added as needed
+    std::vector<std::string> keysM;
+
+    static bool isJSONNumber(const std::string& s);
+    void appendJSONString(const std::string& s);
+public:
+    DataGridJSONExportFormatter(DataGridExportWriter& writer)
+        : DataGridExportFormatter(writer) {}
+
+    virtual void writeHeader(DataGridRows& rows);
+    virtual void writeRow(DataGridRows& rows, unsigned row);
+};
+
+bool DataGridJSONExportFormatter::isJSONNumber(const std::string& s)
+{
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    std::string::const_iterator it = s.begin(), end = s.end();
+    if (it != end && *it == '-')
+        ++it;
+    if (it == end || !isdigit((unsigned char)*it))
+        return false;
+    if (*it == '0' && it + 1 != end && isdigit((unsigned char)*(it + 1)))
+        return false;
+    while (it != end && isdigit((unsigned char)*it))
+        ++it;
+    if (it != end && *it == '.')
+    {
+        if (++it == end || !isdigit((unsigned char)*it))
+            return false;
+        while (it != end && isdigit((unsigned char)*it))
+            ++it;
+    }
+    if (it != end && (*it == 'e' || *it == 'E'))
+    {
+        ++it;
+        if (it != end && (*it == '+' || *it == '-'))
+            ++it;
+        if (it == end || !isdigit((unsigned char)*it))
+            return false;
+        while (it != end && isdigit((unsigned char)*it))
+            ++it;
+    }
+    return it == end;
+}
+
+void DataGridJSONExportFormatter::appendJSONString(const std::string& s)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    writerM.append('"');
+    // UTF-8 sequences only contain bytes >= 0x80, so they are copied as-is
+    for (std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+        unsigned char c = (unsigned char)*it;
+        switch (c)
+        {
+            case '"': writerM.append("\\\"", 2); break;
+            case '\\': writerM.append("\\\\", 2); break;
+            case '\n': writerM.append("\\n", 2); break;
+            case '\r': writerM.append("\\r", 2); break;
+            case '\t': writerM.append("\\t", 2); break;
+            default:
+                if (c < 0x20)
+                {
+                    char escaped[6] = { '\\', 'u', '0', '0',
+                        hexDigits[c >> 4], hexDigits[c & 0x0F] };
+                    writerM.append(escaped, 6);
+                }
+                else
+                    writerM.append(char(c));
+        }
+    }
+    writerM.append('"');
+}
+
+void DataGridJSONExportFormatter::writeHeader(DataGridRows& rows)
+{
+    // the quoted keys are built once, every row only needs to copy them
+    keysM.clear();
+    for (unsigned col = 0; col < rows.getRowFieldCount(); ++col)
+    {
+        std::string name(rows.getRowFieldName(col).utf8_str());
+        std::string key("\"");
+        for (std::string::const_iterator it = name.begin();
+            it != name.end(); ++it)
+        {
+            if (*it == '"' || *it == '\\')
+                key += '\\';
+            key += *it;
+        }
+        key += "\":";
+        keysM.push_back(key);
+    }
+}
+
+void DataGridJSONExportFormatter::writeRow(DataGridRows& rows, unsigned row)
+{
+    writerM.append('{');
+    for (unsigned col = 0; col < keysM.size(); ++col)
+    {
+        if (col > 0)
+            writerM.append(',');
+        writerM.append(keysM[col]);
+        if (rows.isFieldNA(row, col) || rows.isFieldNull(row, col))
+        {
+            writerM.append("null", 4);
+            continue;
+        }
+        std::string value(rows.getFieldValue(row, col).utf8_str());
+        // numbers are written as such unless the configured format makes
+        // them unsuitable (decimal comma, thousands separators, ...)
+        if (rows.isColumnNumeric(col) && isJSONNumber(value))
+            writerM.append(value);
+        else
+            appendJSONString(value);
+    }
+    writerM.append('\n');
+}
+
+// Compact binary format storing blocks of rows column by column, all
+// integers are 32 bit little-endian:
+//   "FRCOLS01", column count, and per column a kind byte (0 = text,
+//   1 = numeric), the name length and the UTF-8 name
+//   blocks of at most blockRows rows: the row count, and per column a null
+//   bitmap of (row count + 7) / 8 bytes (bit set = NULL), the data length
+//   and the non-null values, each as length and UTF-8 text
+//   a row count of 0 marks the end of the file
+class DataGridColumnarExportFormatter: public DataGridExportFormatter
+{
+private:
+    enum { blockRows = 4096 };
+
+    unsigned blockRowCountM;
+    std::vector<std::string> columnDataM;
+    std::vector<std::vector<unsigned char> > columnNullsM;
+
+    static void appendValue(std::string& data, const std::string& value);
+    void writeBlock();
+public:
+    DataGridColumnarExportFormatter(DataGridExportWriter& writer)
+        : DataGridExportFormatter(writer), blockRowCountM(0) {}
+
+    virtual void writeHeader(DataGridRows& rows);
+    virtual void writeRow(DataGridRows& rows, unsigned row);
+    virtual void writeFooter();
+};
+
+void DataGridColumnarExportFormatter::appendValue(std::string& data,
+    const std::string& value)
+{
+    uint32_t length = uint32_t(value.size());
+    for (int i = 0; i < 4; ++i)
+        data += char((length >> (8 * i)) & 0xFF);
+    data += value;
+}
+
+void DataGridColumnarExportFormatter::writeHeader(DataGridRows& rows)
+{
+    unsigned colCount = rows.getRowFieldCount();
+    writerM.append("FRCOLS01", 8);
+    writerM.appendUInt32(colCount);
+    for (unsigned col = 0; col < colCount; ++col)
+    {
+        std::string name(rows.getRowFieldName(col).utf8_str());
+        writerM.append(char(rows.isColumnNumeric(col) ? 1 : 0));
+        writerM.appendUInt32(uint32_t(name.size()));
+        writerM.append(name);
+    }
+    columnDataM.assign(colCount, std::string());
+    columnNullsM.assign(colCount,
+        std::vector<unsigned char>((blockRows + 7) / 8, 0));
+    blockRowCountM = 0;
+}
+
+void DataGridColumnarExportFormatter::writeRow(DataGridRows& rows,
+    unsigned row)
+{
+    for (unsigned col = 0; col < columnDataM.size(); ++col)
+    {
+        if (rows.isFieldNA(row, col) || rows.isFieldNull(row, col))
+        {
+            columnNullsM[col][blockRowCountM / 8] |=
+                (unsigned char)(1 << (blockRowCountM % 8));
+        }
+        else
+        {
+            appendValue(columnDataM[col],
+                std::string(rows.getFieldValue(row, col).utf8_str()));
+        }
+    }
+    if (++blockRowCountM == blockRows)
+        writeBlock();
+}
+
+void DataGridColumnarExportFormatter::writeBlock()
+{
+    if (blockRowCountM == 0)
+        return;
+    writerM.appendUInt32(blockRowCountM);
+    for (unsigned col = 0; col < columnDataM.size(); ++col)
+    {
+        std::vector<unsigned char>& nulls = columnNullsM[col];
+        writerM.append((const char*)&nulls[0], (blockRowCountM + 7) / 8);
+        writerM.appendUInt32(uint32_t(columnDataM[col].size()));
+        writerM.append(columnDataM[col]);
+        // keep the capacity for the next block
+        columnDataM[col].clear();
+        std::fill(nulls.begin(), nulls.end(), 0);
+    }
+    blockRowCountM = 0;
+}
+
+void DataGridColumnarExportFormatter::writeFooter()
+{
+    writeBlock();
+    writerM.appendUInt32(0);
+}
+
 DataGridTable::DataGridTable(IBPP::Statement& s, Database* db)
     : wxGridTableBase(), statementM(s), databaseM(db), nullFlagM(false),
-        rowsM(db)
+        rowsM(db), fetchThreadM(0)
 {
     allRowsFetchedM = false;
     fetchAllRowsM = false;
@@ -56,6 +625,7 @@ DataGridTable::DataGridTable(IBPP::Statement& s, Database* db)
     canInsertRowsIsSetM = false;
     canInsertRowsM = false;
     config().getValue("GridFetchAllRecords", fetchAllRowsM);
+    fetchAllInBackgroundM = config().get("GridFetchAllInBackground", true);
     maxRowToFetchM = 100;
     cellAttriM = new wxGridCellAttr();
 }
@@ -80,12 +650,15 @@ bool DataGridTable::canFetchMoreRows()
 
 void DataGridTable::Clear()
 {
+    // the fetch thread must not outlive the statement or the row buffers
+    stopFetchThread();
     nullFlagM = false;
 
     allRowsFetchedM = true;
     fetchAllRowsM = false;
     canInsertRowsIsSetM = false;
     config().getValue("GridFetchAllRecords", fetchAllRowsM);
+    fetchAllInBackgroundM = config().get("GridFetchAllInBackground", true);
 
     unsigned oldCols = rowsM.getRowFieldCount();
     unsigned oldRows = rowsM.getRowCount();
@@ -126,9 +699,22 @@ void DataGridTable::fetch()
     if (!canFetchMoreRows())
         return;
 
+    if (fetchThreadM)
+    {
+        collectFetchedRows();
+        return;
+    }
+
     // fetch the first 100 rows no matter how long it takes
     unsigned oldRows = rowsM.getRowCount();
     bool initial = oldRows == 0;
+    // fetching all rows is done by a worker thread to keep the GUI
+    // responsive, the statement must not be used here until it is done
+    if (fetchAllRowsM && !initial && canFetchInBackground())
+    {
+        startFetchThread();
+        return;
+    }
     // fetch more rows until maxRowToFetchM reached or 100 ms elapsed
     wxLongLong startms = ::wxGetLocalTimeMillis();
     do
@@ -159,6 +745,11 @@ void DataGridTable::fetch()
     }
     while ((fetchAllRowsM && !initial) || rowsM.getRowCount() < maxRowToFetchM);
 
+    notifyRowsAppended(oldRows);
+}
+
+void DataGridTable::notifyRowsAppended(unsigned oldRows)
+{
     if (rowsM.getRowCount() > oldRows && GetView())   // notify the grid
     {
         wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED,
@@ -171,6 +762,72 @@ void DataGridTable::fetch()
     }
 }
 
+bool DataGridTable::canFetchInBackground()
+{
+    if (!fetchAllInBackgroundM)
+        return false;
+    // IBPP reference counting isn't thread-safe, and creating the blob
+    // objects for BLOB columns would use the database and transaction
+    // objects shared with the GUI thread
+    for (unsigned col = 0; col < rowsM.getRowFieldCount(); ++col)
+    {
+        if (rowsM.isBlobColumn(col))
+            return false;
+    }
+    return true;
+}
+
+void DataGridTable::startFetchThread()
+{
+    wxASSERT(!fetchThreadM);
+    fetchThreadM = new DataGridFetchThread(rowsM, statementM);
+    if (fetchThreadM->Run() != wxTHREAD_NO_ERROR)
+    {
+        delete fetchThreadM;
+        fetchThreadM = 0;
+        fetchAllInBackgroundM = false;
+    }
+}
+
+void DataGridTable::stopFetchThread()
+{
+    if (!fetchThreadM)
+        return;
+    fetchThreadM->cancel();
+    fetchThreadM->Wait();
+    // rows fetched so far are valid, keep them
+    collectFetchedRows();
+}
+
+void DataGridTable::collectFetchedRows()
+{
+    if (!fetchThreadM)
+        return;
+
+    unsigned oldRows = rowsM.getRowCount();
+    bool finished = fetchThreadM->isFinished();
+    while (DataGridRowBatchQueue::Batch* batch = fetchThreadM->popBatch())
+    {
+        rowsM.addRows(*batch);
+        delete batch;
+    }
+
+    if (finished)
+    {
+        fetchThreadM->Wait();
+        allRowsFetchedM = fetchThreadM->reachedEnd();
+        wxString error(fetchThreadM->getError());
+        delete fetchThreadM;
+        fetchThreadM = 0;
+        if (!error.empty())
+        {
+            ::wxMessageBox(error, _("An IBPP error occurred."),
+                wxOK|wxICON_ERROR);
+        }
+    }
+    notifyRowsAppended(oldRows);
+}
+
 void DataGridTable::addRow(DataGridRowBuffer *buffer, const wxString& sql)
 {
     rowsM.addRow(buffer);
@@ -293,6 +950,111 @@ wxString DataGridTable::getCellValueForCSV(int row, int col,
     return sTextDelim + s + sTextDelim;
 }
 
+unsigned DataGridTable::exportAllRows(const wxString& fileName,
+    DataGridExportFormat format, const wxChar& fieldDelimiter,
+    const wxChar& textDelimiter, ProgressIndicator* pi)
+{
+    // the export takes over the statement
+    stopFetchThread();
+
+    wxFFile file(fileName, "wb");
+    if (!file.IsOpened())
+        throw FRError(_("Cannot open destination file."));
+    DataGridExportWriter writer(file);
+    std::unique_ptr<DataGridExportFormatter> formatter;
+    switch (format)
+    {
+        case defJSONLines:
+            formatter.reset(new DataGridJSONExportFormatter(writer));
+            break;
+        case defColumnar:
+            formatter.reset(new DataGridColumnarExportFormatter(writer));
+            break;
+        default:
+            formatter.reset(new DataGridCSVExportFormatter(writer,
+                fieldDelimiter, textDelimiter));
+            break;
+    }
+
+    formatter->writeHeader(rowsM);
+    unsigned rowCount = rowsM.getRowCount();
+    if (pi)
+        pi->initProgress(_("Writing fetched records..."), rowCount);
+    unsigned exported = 0;
+    for (; exported < rowCount; ++exported)
+    {
+        if (pi && exported % 1000 == 0)
+        {
+            if (pi->isCanceled())
+                break;
+            pi->setProgressPosition(exported);
+        }
+        formatter->writeRow(rowsM, exported);
+    }
+
+    if (exported == rowCount && canFetchMoreRows())
+    {
+        // rows exported from here on are not in the grid, and the grid
+        // must not fetch from the cursor while the export uses it; the
+        // grid can fetch the remaining rows again if the export stops
+        // before the end of the result set
+        allRowsFetchedM = true;
+        bool reachedEnd = false;
+        try
+        {
+            if (pi)
+                pi->initProgressIndeterminate(_("Writing remaining records..."));
+
+            // every block of rows is fetched into a separate row set and freed
+            // after it has been written, so memory use doesn't grow with the
+            // size of the result set
+            const int blockRows = 256;
+            DataGridRows blockData(databaseM);
+            blockData.initialize(statementM);
+            while (!pi || !pi->isCanceled())
+            {
+                // the cursor is closed once Fetch() returned false, so it
+                // must not be called again after the last block
+                int fetched = 0;
+                while (fetched < blockRows)
+                {
+                    if (!statementM->Fetch())
+                    {
+                        reachedEnd = true;
+                        break;
+                    }
+                    blockData.addRow(statementM);
+                    ++fetched;
+                }
+                for (int i = 0; i < fetched; ++i)
+                    formatter->writeRow(blockData, i);
+                blockData.clearRows();
+                exported += fetched;
+
+                if (reachedEnd)
+                    break;
+                if (pi)
+                {
+                    pi->setProgressMessage(wxString::Format(
+                        _("Writing remaining records... (%u written)"),
+                        exported));
+                    pi->stepProgress();
+                }
+            }
+        }
+        catch (...)
+        {
+            allRowsFetchedM = false;
+            throw;
+        }
+        allRowsFetchedM = reachedEnd;
+    }
+
+    formatter->writeFooter();
+    writer.flush();
+    return exported;
+}
+
 wxString DataGridTable::GetColLabelValue(int col)
 {
     return rowsM.getRowFieldName(col);
@@ -303,6 +1065,11 @@ bool DataGridTable::getFetchAllRows()
     return fetchAllRowsM;
 }
 
+bool DataGridTable::isFetchingInBackground()
+{
+    return fetchThreadM != 0;
+}
+
 int DataGridTable::GetNumberCols()
 {
     return rowsM.getRowFieldCount();
@@ -502,6 +1269,14 @@ bool DataGridTable::isNumericColumn(int col)
     return rowsM.isColumnNumeric(col);
 }
 
+void DataGridTable::aggregateColumn(int col, int firstRow, int lastRow,
+    DataGridAggregates& aggregates)
+{
+    if (col < 0 || firstRow < 0 || lastRow < firstRow)
+        return;
+    rowsM.aggregateColumn(col, firstRow, lastRow, aggregates);
+}
+
 bool DataGridTable::isReadonlyColumn(int col)
 {
     return readOnlyM || rowsM.isColumnReadonly(col);
@@ -542,6 +1317,8 @@ bool DataGridTable::needsMoreRowsFetched()
 void DataGridTable::setFetchAllRecords(bool fetchall)
 {
     fetchAllRowsM = fetchall;
+    if (!fetchAllRowsM)
+        stopFetchThread();
 }
 
 IBPP::Blob* DataGridTable::getBlob(unsigned row, unsigned col, bool validateBlob)
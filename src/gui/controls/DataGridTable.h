@@ -35,6 +35,7 @@
 class Column;
 class Database;
 class DataGridCell;
+class DataGridFetchThread;
 class ResultsetColumnDef;
 class DataGridRowBuffer;
 class ProgressIndicator;
@@ -49,11 +50,21 @@ BEGIN_DECLARE_EVENT_TYPES()
     DECLARE_LOCAL_EVENT_TYPE(wxEVT_FRDG_INVALIDATEATTR, 44)
 END_DECLARE_EVENT_TYPES()
 
+// file formats for DataGridTable::exportAllRows()
+// ** Keep in sync with radiogroup control in export_data.confdef **
+enum DataGridExportFormat
+{
+    defCSV = 0,
+    defJSONLines = 1,
+    defColumnar = 2
+};
+
 class DataGridTable: public wxGridTableBase
 {
 private:
     bool allRowsFetchedM;
     bool fetchAllRowsM;
+    bool fetchAllInBackgroundM;
     unsigned maxRowToFetchM;
     bool readOnlyM;
     bool canInsertRowsIsSetM;
@@ -68,8 +79,17 @@ private:
     IBPP::Statement& statementM;
     wxMBConv* charsetConverterM;
 
+    // owns statementM while all remaining rows are fetched in background
+    DataGridFetchThread* fetchThreadM;
+
     int getStatementColCount();
     bool isValidCellPos(int row, int col);
+    void notifyRowsAppended(unsigned oldRows);
+
+    bool canFetchInBackground();
+    void startFetchThread();
+    void stopFetchThread();
+    void collectFetchedRows();
 public:
     DataGridTable(IBPP::Statement& s, Database* db);
     ~DataGridTable();
@@ -81,7 +101,13 @@ public:
     wxString getCellValue(int row, int col);
     wxString getCellValueForInsert(int row, int col);
     wxString getCellValueForCSV(int row, int col, const wxChar& textDelimiter);
+    // writes the fetched rows and then all remaining rows of the open
+    // cursor to a file, the remaining rows are not added to the grid
+    unsigned exportAllRows(const wxString& fileName,
+        DataGridExportFormat format, const wxChar& fieldDelimiter,
+        const wxChar& textDelimiter, ProgressIndicator* pi = 0);
     bool getFetchAllRows();
+    bool isFetchingInBackground();
 
     // TODO: these should be replaced with a better function that covers all
     wxString getTableName();
@@ -94,6 +120,8 @@ public:
     bool isNullableColumn(int col);
     bool isNullCell(int row, int col);
     bool isNumericColumn(int col);
+    void aggregateColumn(int col, int firstRow, int lastRow,
+        DataGridAggregates& aggregates);
     bool isReadonlyColumn(int col);
     bool isBlobColumn(int col, bool* pIsTextual = 0);
     bool needsMoreRowsFetched();
@@ -53,6 +53,7 @@
 
 #include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <cstdarg>
@@ -998,6 +999,32 @@ private:
     DatabaseImpl* mDatabase;        // Related Database (important for Blobs, ...)
     TransactionImpl* mTransaction;  // Related Transaction (same remark)
 
+    // Accessor plan, built once the columns are described: a decoder
+    // matching the sqltype of each column, and the column numbers by
+    // upper case name and alias
+    typedef void* (RowImpl::*Decoder)(int, XSQLVAR*, IITYPE, void*);
+    std::vector<Decoder> mDecoders;
+    std::unordered_map<std::string, int> mColumnNums;
+    void BuildPlan();
+
+    void* DecodeBoolean(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeText(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeVarying(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeShort(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeLong(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeInt64(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeRaw(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeFloat(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeDouble(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeTimestamp(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeDate(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeTime(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeBlob(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeArray(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeTimestampTz(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeTimeTz(int, XSQLVAR*, IITYPE, void*);
+    void* DecodeUnknown(int, XSQLVAR*, IITYPE, void*);
+
     void SetValue(int, IITYPE, const void* value, int = 0);
     void* GetValue(int, IITYPE, void* = 0);
 
@@ -1042,6 +1069,7 @@ public:
     bool Get(int, char*);       // c-strings, len unchecked
     bool Get(int, void*, int&); // byte buffers
     bool Get(int, std::string&);
+    bool GetText(int, const char*&, int&);  // CHAR/VARCHAR in place
     bool Get(int, int16_t&);
     bool Get(int, int32_t&);
     bool Get(int, int64_t&);
@@ -1202,6 +1230,7 @@ public:
     bool Get(int, char*);               // c-strings, len unchecked
     bool Get(int, void*, int&);         // byte buffers
     bool Get(int, std::string&);
+    bool GetText(int, const char*&, int&);  // CHAR/VARCHAR in place
     bool Get(int, int16_t*);
     bool Get(int, int16_t&);
     bool Get(int, int32_t*);
@@ -788,6 +788,7 @@ public:
         virtual bool Get(int, bool&) = 0;
         virtual bool Get(int, void*, int&) = 0; // byte buffers
         virtual bool Get(int, std::string&) = 0;
+        virtual bool GetText(int, const char*&, int&) = 0; // CHAR/VARCHAR in place
         virtual bool Get(int, int16_t&) = 0;
         virtual bool Get(int, int32_t&) = 0;
         virtual bool Get(int, int64_t&) = 0;
@@ -908,6 +909,7 @@ public:
         virtual bool Get(int, bool&) = 0;
         virtual bool Get(int, void*, int&) = 0; // byte buffers
         virtual bool Get(int, std::string&) = 0;
+        virtual bool GetText(int, const char*&, int&) = 0; // CHAR/VARCHAR in place
         virtual bool Get(int, int16_t&) = 0;
         virtual bool Get(int, int32_t&) = 0;
         virtual bool Get(int, int64_t&) = 0;
@@ -326,6 +326,23 @@ bool RowImpl::Get(int column, std::string& retvalue)
 	return pvalue == 0 ? true : false;
 }
 
+bool RowImpl::GetText(int column, const char*& text, int& length)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::GetText", _("The row is not initialized."));
+
+	// Returns the CHAR/VARCHAR data in place, without copying it
+	void* pvalue = GetValue(column, ivByte, &length);
+	if (pvalue == 0)
+	{
+		text = 0;
+		length = 0;
+		return true;
+	}
+	text = (const char*)pvalue;
+	return false;
+}
+
 bool RowImpl::Get(int column, int16_t& retvalue)
 {
 	if (mDescrArea == 0)
@@ -644,44 +661,17 @@ int RowImpl::ColumnNum(const std::string& name)
 		throw LogicExceptionImpl("Row::ColumnNum", _("The row is not initialized."));
 	if (name.empty())
 		throw LogicExceptionImpl("Row::ColumnNum", _("Column name <empty> not found."));
+	if ((int)mDecoders.size() != mDescrArea->sqld) BuildPlan();
 
-	XSQLVAR* var;
-	char Uname[sizeof(var->sqlname)+1];		// Max size of sqlname + '\0'
-
-	// Local upper case copy of the column name
-	size_t len = name.length();
-	if (len > sizeof(var->sqlname)) len = sizeof(var->sqlname);
-	strncpy(Uname, name.c_str(), len);
-	Uname[len] = '\0';
-	char* p = Uname;
-	while (*p != '\0') { *p = char(toupper(*p)); ++p; }
+	// Local upper case copy of the column name, names and aliases
+	// are at most as long as XSQLVAR::sqlname
+	std::string Uname(name, 0, sizeof(XSQLVAR::sqlname));
+	for (std::string::iterator p = Uname.begin(); p != Uname.end(); ++p)
+		*p = char(toupper(*p));
 
-	// Loop through the columns of the descriptor
-	for (int i = 0; i < mDescrArea->sqld; i++)
-	{
-		var = &(mDescrArea->sqlvar[i]);
-		if (var->sqlname_length != (int16_t)len) continue;
-		if (strncmp(Uname, var->sqlname, len) == 0) return i+1;
-	}
-
-	// Failed finding the column name, let's retry using the aliases
-	char Ualias[sizeof(var->aliasname)+1];		// Max size of aliasname + '\0'
-
-	// Local upper case copy of the column name
-	len = name.length();
-	if (len > sizeof(var->aliasname)) len = sizeof(var->aliasname);
-	strncpy(Ualias, name.c_str(), len);
-	Ualias[len] = '\0';
-	p = Ualias;
-	while (*p != '\0') { *p = char(toupper(*p)); ++p; }
-
-	// Loop through the columns of the descriptor
-	for (int i = 0; i < mDescrArea->sqld; i++)
-	{
-		var = &(mDescrArea->sqlvar[i]);
-		if (var->aliasname_length != (int16_t)len) continue;
-		if (strncmp(Ualias, var->aliasname, len) == 0) return i+1;
-	}
+	std::unordered_map<std::string, int>::const_iterator it =
+		mColumnNums.find(Uname);
+	if (it != mColumnNums.end()) return it->second;
 
 	throw LogicExceptionImpl("Row::ColumnNum", _("Could not find matching column."));
 }
@@ -1140,354 +1130,364 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 {
 	if (varnum < 1 || varnum > mDescrArea->sqld)
 		throw LogicExceptionImpl("RowImpl::GetValue", _("Variable index out of range."));
+	if ((int)mDecoders.size() != mDescrArea->sqld) BuildPlan();
 
-	void* value;
-	int len;
 	XSQLVAR* var = &(mDescrArea->sqlvar[varnum-1]);
 
 	// When there is no value (SQL NULL)
 	if ((var->sqltype & 1) && *(var->sqlind) != 0) return 0;
 
-	switch (var->sqltype & ~1)
+	return (this->*mDecoders[varnum-1])(varnum, var, ivType, retvalue);
+}
+
+void RowImpl::BuildPlan()
+{
+	// The sqltype of each column is only inspected here, every later
+	// GetValue() directly calls the decoder matching it
+	mDecoders.resize(mDescrArea->sqld);
+	for (int i = 0; i < mDescrArea->sqld; i++)
 	{
-		    case SQL_BOOLEAN : // Firebird v3
-			if (ivType == ivString)
-			{
-				value = &var->sqldata[0];
-			}
-			else if (ivType == ivBool)
-			{
-				value = var->sqldata;
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
-		    
-			case SQL_TEXT :
-			if (ivType == ivString)
-			{
-				// In case of ivString, 'void* retvalue' points to a std::string where we
-				// will directly store the data.
-				std::string* str = (std::string*)retvalue;
-				str->erase();
-				str->append(var->sqldata, var->sqllen);
-				value = retvalue;	// value != 0 means 'not null'
-			}
-			else if (ivType == ivByte)
-			{
-				// In case of ivByte, void* retvalue points to an int where we
-				// will store the len of the available data
-				if (retvalue != 0) *(int*)retvalue = var->sqllen;
-				value = var->sqldata;
-			}
-			else if (ivType == ivDBKey)
-			{
-				IBPP::DBKey* key = (IBPP::DBKey*)retvalue;
-				key->SetKey(var->sqldata, var->sqllen);
-				value = retvalue;
-			}
-			else if (ivType == ivBool)
-			{
-				mBools[varnum-1] = 0;
-				if (var->sqllen >= 1)
-				{
-					char c = var->sqldata[0];
-					if (c == 't' || c == 'T' || c == 'y' || c == 'Y' ||	c == '1')
-						mBools[varnum-1] = 1;
-				}
-				value = &mBools[varnum-1];
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+		Decoder decoder;
+		switch (mDescrArea->sqlvar[i].sqltype & ~1)
+		{
+			case SQL_BOOLEAN :		decoder = &RowImpl::DecodeBoolean; break;
+			case SQL_TEXT :			decoder = &RowImpl::DecodeText; break;
+			case SQL_VARYING :		decoder = &RowImpl::DecodeVarying; break;
+			case SQL_SHORT :		decoder = &RowImpl::DecodeShort; break;
+			case SQL_LONG :			decoder = &RowImpl::DecodeLong; break;
+			case SQL_INT64 :		decoder = &RowImpl::DecodeInt64; break;
+			case SQL_INT128 :
+			case SQL_DEC16 :
+			case SQL_DEC34 :		decoder = &RowImpl::DecodeRaw; break;
+			case SQL_FLOAT :		decoder = &RowImpl::DecodeFloat; break;
+			case SQL_DOUBLE :		decoder = &RowImpl::DecodeDouble; break;
+			case SQL_TIMESTAMP :	decoder = &RowImpl::DecodeTimestamp; break;
+			case SQL_TYPE_DATE :	decoder = &RowImpl::DecodeDate; break;
+			case SQL_TYPE_TIME :	decoder = &RowImpl::DecodeTime; break;
+			case SQL_BLOB :			decoder = &RowImpl::DecodeBlob; break;
+			case SQL_ARRAY :		decoder = &RowImpl::DecodeArray; break;
+			case SQL_TIMESTAMP_TZ :	decoder = &RowImpl::DecodeTimestampTz; break;
+			case SQL_TIME_TZ :		decoder = &RowImpl::DecodeTimeTz; break;
+			default :				decoder = &RowImpl::DecodeUnknown; break;
+		}
+		mDecoders[i] = decoder;
+	}
 
-		case SQL_VARYING :
-			if (ivType == ivString)
-			{
-				// In case of ivString, 'void* retvalue' points to a std::string where we
-				// will directly store the data.
-				std::string* str = (std::string*)retvalue;
-				str->erase();
-				str->append(var->sqldata+2, (int32_t)*(int16_t*)var->sqldata);
-				value = retvalue;
-			}
-			else if (ivType == ivByte)
-			{
-				// In case of ivByte, void* retvalue points to an int where we
-				// will store the len of the available data
-				if (retvalue != 0) *(int*)retvalue = (int)*(int16_t*)var->sqldata;
-				value = var->sqldata+2;
-			}
-			else if (ivType == ivBool)
-			{
-				mBools[varnum-1] = 0;
-				len = *(int16_t*)var->sqldata;
-				if (len >= 1)
-				{
-					char c = var->sqldata[2];
-					if (c == 't' || c == 'T' || c == 'y' || c == 'Y' ||	c == '1')
-						mBools[varnum-1] = 1;
-				}
-				value = &mBools[varnum-1];
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+	// Column names take precedence over aliases, and the first column
+	// wins when several have the same name, as in the former linear scan
+	mColumnNums.clear();
+	for (int i = 0; i < mDescrArea->sqld; i++)
+	{
+		XSQLVAR* var = &(mDescrArea->sqlvar[i]);
+		mColumnNums.insert(std::make_pair(
+			std::string(var->sqlname, var->sqlname_length), i+1));
+	}
+	for (int i = 0; i < mDescrArea->sqld; i++)
+	{
+		XSQLVAR* var = &(mDescrArea->sqlvar[i]);
+		mColumnNums.insert(std::make_pair(
+			std::string(var->aliasname, var->aliasname_length), i+1));
+	}
+}
 
-		case SQL_SHORT :
-			if (ivType == ivInt16)
-			{
-				value = var->sqldata;
-			}
-			else if (ivType == ivBool)
-			{
-				if (*(int16_t*)var->sqldata == 0) mBools[varnum-1] = 0;
-				else mBools[varnum-1] = 1;
-				value = &mBools[varnum-1];
-			}
-			else if (ivType == ivInt32)
-			{
-				mInt32s[varnum-1] = *(int16_t*)var->sqldata;
-				value = &mInt32s[varnum-1];
-			}
-			else if (ivType == ivInt64)
-			{
-				mInt64s[varnum-1] = *(int16_t*)var->sqldata;
-				value = &mInt64s[varnum-1];
-			}
-			else if (ivType == ivFloat)
-			{
-				// This SQL_SHORT is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int16_t*)var->sqldata / divisor);
+void* RowImpl::DecodeBoolean(int, XSQLVAR* var, IITYPE ivType, void*)
+{
+	// Firebird v3
+	if (ivType != ivString && ivType != ivBool)
+		throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	return var->sqldata;
+}
 
-				value = &mFloats[varnum-1];
-			}
-			else if (ivType == ivDouble)
-			{
-				// This SQL_SHORT is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int16_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeText(int varnum, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType == ivString)
+	{
+		// In case of ivString, 'void* retvalue' points to a std::string where we
+		// will directly store the data.
+		std::string* str = (std::string*)retvalue;
+		str->assign(var->sqldata, var->sqllen);
+		return retvalue;	// value != 0 means 'not null'
+	}
+	if (ivType == ivByte)
+	{
+		// In case of ivByte, void* retvalue points to an int where we
+		// will store the len of the available data
+		if (retvalue != 0) *(int*)retvalue = var->sqllen;
+		return var->sqldata;
+	}
+	if (ivType == ivDBKey)
+	{
+		IBPP::DBKey* key = (IBPP::DBKey*)retvalue;
+		key->SetKey(var->sqldata, var->sqllen);
+		return retvalue;
+	}
+	if (ivType == ivBool)
+	{
+		mBools[varnum-1] = 0;
+		if (var->sqllen >= 1)
+		{
+			char c = var->sqldata[0];
+			if (c == 't' || c == 'T' || c == 'y' || c == 'Y' ||	c == '1')
+				mBools[varnum-1] = 1;
+		}
+		return &mBools[varnum-1];
+	}
+	throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+							_("Incompatible types."));
+}
 
-		case SQL_LONG :
-			if (ivType == ivInt32)
-			{
-				value = var->sqldata;
-			}
-			else if (ivType == ivBool)
-			{
-				if (*(int32_t*)var->sqldata == 0) mBools[varnum-1] = 0;
-				else mBools[varnum-1] = 1;
-				value = &mBools[varnum-1];
-			}
-			else if (ivType == ivInt16)
-			{
-				int32_t tmp = *(int32_t*)var->sqldata;
-				if (tmp < consts::min16 || tmp > consts::max16)
-					throw LogicExceptionImpl("RowImpl::GetValue",
-						_("Out of range numeric conversion !"));
-				mInt16s[varnum-1] = (int16_t)tmp;
-				value = &mInt16s[varnum-1];
-			}
-			else if (ivType == ivInt64)
-			{
-				mInt64s[varnum-1] = *(int32_t*)var->sqldata;
-				value = &mInt64s[varnum-1];
-			}
-			else if (ivType == ivFloat)
-			{
-				// This SQL_LONG is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int32_t*)var->sqldata / divisor);
-				value = &mFloats[varnum-1];
-			}
-			else if (ivType == ivDouble)
-			{
-				// This SQL_LONG is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int32_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeVarying(int varnum, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType == ivString)
+	{
+		// In case of ivString, 'void* retvalue' points to a std::string where we
+		// will directly store the data.
+		std::string* str = (std::string*)retvalue;
+		str->assign(var->sqldata+2, (int32_t)*(int16_t*)var->sqldata);
+		return retvalue;
+	}
+	if (ivType == ivByte)
+	{
+		// In case of ivByte, void* retvalue points to an int where we
+		// will store the len of the available data
+		if (retvalue != 0) *(int*)retvalue = (int)*(int16_t*)var->sqldata;
+		return var->sqldata+2;
+	}
+	if (ivType == ivBool)
+	{
+		mBools[varnum-1] = 0;
+		int len = *(int16_t*)var->sqldata;
+		if (len >= 1)
+		{
+			char c = var->sqldata[2];
+			if (c == 't' || c == 'T' || c == 'y' || c == 'Y' ||	c == '1')
+				mBools[varnum-1] = 1;
+		}
+		return &mBools[varnum-1];
+	}
+	throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+							_("Incompatible types."));
+}
 
-		case SQL_INT64 :
-			if (ivType == ivInt64)
-			{
-				value = var->sqldata;
-			}
-			else if (ivType == ivBool)
-			{
-				if (*(int64_t*)var->sqldata == 0) mBools[varnum-1] = 0;
-				else mBools[varnum-1] = 1;
-				value = &mBools[varnum-1];
-			}
-			else if (ivType == ivInt16)
-			{
-				int64_t tmp = *(int64_t*)var->sqldata;
-				if (tmp < consts::min16 || tmp > consts::max16)
-					throw LogicExceptionImpl("RowImpl::GetValue",
-						_("Out of range numeric conversion !"));
-				mInt16s[varnum-1] = (int16_t)tmp;
-				value = &mInt16s[varnum-1];
-			}
-			else if (ivType == ivInt32)
-			{
-				int64_t tmp = *(int64_t*)var->sqldata;
-				if (tmp < consts::min32 || tmp > consts::max32)
-					throw LogicExceptionImpl("RowImpl::GetValue",
-						_("Out of range numeric conversion !"));
-				mInt32s[varnum-1] = (int32_t)tmp;
-				value = &mInt32s[varnum-1];
-			}
-			else if (ivType == ivFloat)
-			{
-				// This SQL_INT64 is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int64_t*)var->sqldata / divisor);
-				value = &mFloats[varnum-1];
-			}
-			else if (ivType == ivDouble)
-			{
-				// This SQL_INT64 is a NUMERIC(x,y), scale it !
-				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int64_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeShort(int varnum, XSQLVAR* var, IITYPE ivType, void*)
+{
+	int16_t value = *(int16_t*)var->sqldata;
+	switch (ivType)
+	{
+		case ivInt16 :
+			return var->sqldata;
+		case ivBool :
+			mBools[varnum-1] = (value == 0) ? 0 : 1;
+			return &mBools[varnum-1];
+		case ivInt32 :
+			mInt32s[varnum-1] = value;
+			return &mInt32s[varnum-1];
+		case ivInt64 :
+			mInt64s[varnum-1] = value;
+			return &mInt64s[varnum-1];
+		case ivFloat :
+			// This SQL_SHORT is a NUMERIC(x,y), scale it !
+			mFloats[varnum-1] = (float)(value / consts::dscales[-var->sqlscale]);
+			return &mFloats[varnum-1];
+		case ivDouble :
+			// This SQL_SHORT is a NUMERIC(x,y), scale it !
+			mNumerics[varnum-1] = value / consts::dscales[-var->sqlscale];
+			return &mNumerics[varnum-1];
+		default :
+			throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+									_("Incompatible types."));
+	}
+}
 
-		case SQL_INT128 :
-			if (ivType == ivInt128)
-			{
-				value = var->sqldata;
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeLong(int varnum, XSQLVAR* var, IITYPE ivType, void*)
+{
+	int32_t value = *(int32_t*)var->sqldata;
+	switch (ivType)
+	{
+		case ivInt32 :
+			return var->sqldata;
+		case ivBool :
+			mBools[varnum-1] = (value == 0) ? 0 : 1;
+			return &mBools[varnum-1];
+		case ivInt16 :
+			if (value < consts::min16 || value > consts::max16)
+				throw LogicExceptionImpl("RowImpl::GetValue",
+					_("Out of range numeric conversion !"));
+			mInt16s[varnum-1] = (int16_t)value;
+			return &mInt16s[varnum-1];
+		case ivInt64 :
+			mInt64s[varnum-1] = value;
+			return &mInt64s[varnum-1];
+		case ivFloat :
+			// This SQL_LONG is a NUMERIC(x,y), scale it !
+			mFloats[varnum-1] = (float)(value / consts::dscales[-var->sqlscale]);
+			return &mFloats[varnum-1];
+		case ivDouble :
+			// This SQL_LONG is a NUMERIC(x,y), scale it !
+			mNumerics[varnum-1] = value / consts::dscales[-var->sqlscale];
+			return &mNumerics[varnum-1];
+		default :
+			throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+									_("Incompatible types."));
+	}
+}
 
-		case SQL_DEC16 :
-			if (ivType == ivDec16)
-			{
-				value = var->sqldata;
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeInt64(int varnum, XSQLVAR* var, IITYPE ivType, void*)
+{
+	int64_t value = *(int64_t*)var->sqldata;
+	switch (ivType)
+	{
+		case ivInt64 :
+			return var->sqldata;
+		case ivBool :
+			mBools[varnum-1] = (value == 0) ? 0 : 1;
+			return &mBools[varnum-1];
+		case ivInt16 :
+			if (value < consts::min16 || value > consts::max16)
+				throw LogicExceptionImpl("RowImpl::GetValue",
+					_("Out of range numeric conversion !"));
+			mInt16s[varnum-1] = (int16_t)value;
+			return &mInt16s[varnum-1];
+		case ivInt32 :
+			if (value < consts::min32 || value > consts::max32)
+				throw LogicExceptionImpl("RowImpl::GetValue",
+					_("Out of range numeric conversion !"));
+			mInt32s[varnum-1] = (int32_t)value;
+			return &mInt32s[varnum-1];
+		case ivFloat :
+			// This SQL_INT64 is a NUMERIC(x,y), scale it !
+			mFloats[varnum-1] = (float)(value / consts::dscales[-var->sqlscale]);
+			return &mFloats[varnum-1];
+		case ivDouble :
+			// This SQL_INT64 is a NUMERIC(x,y), scale it !
+			mNumerics[varnum-1] = value / consts::dscales[-var->sqlscale];
+			return &mNumerics[varnum-1];
+		default :
+			throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+									_("Incompatible types."));
+	}
+}
 
-		case SQL_DEC34 :
-			if (ivType == ivDec34)
-			{
-				value = var->sqldata;
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
+void* RowImpl::DecodeRaw(int, XSQLVAR* var, IITYPE ivType, void*)
+{
+	// SQL_INT128, SQL_DEC16 and SQL_DEC34 are only read as themselves
+	IITYPE expected;
+	switch (var->sqltype & ~1)
+	{
+		case SQL_INT128 :	expected = ivInt128; break;
+		case SQL_DEC16 :	expected = ivDec16; break;
+		default :			expected = ivDec34; break;
+	}
+	if (ivType != expected)
+		throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	return var->sqldata;
+}
 
-		case SQL_FLOAT :
-			if (ivType != ivFloat)
-				throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			value = var->sqldata;
-			break;
+void* RowImpl::DecodeFloat(int, XSQLVAR* var, IITYPE ivType, void*)
+{
+	if (ivType != ivFloat)
+		throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	return var->sqldata;
+}
 
-		case SQL_DOUBLE :
-			if (ivType != ivDouble)
-				throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			if (var->sqlscale < 0)
-			{
-				// Round to scale y of NUMERIC(x,y)
-				double multiplier = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] =
-					floor(*(double*)var->sqldata * multiplier + 0.5) / multiplier;
-				value = &mNumerics[varnum-1];
-			}
-			else value = var->sqldata;
-			break;
+void* RowImpl::DecodeDouble(int varnum, XSQLVAR* var, IITYPE ivType, void*)
+{
+	if (ivType != ivDouble)
+		throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	if (var->sqlscale < 0)
+	{
+		// Round to scale y of NUMERIC(x,y)
+		double multiplier = consts::dscales[-var->sqlscale];
+		mNumerics[varnum-1] =
+			floor(*(double*)var->sqldata * multiplier + 0.5) / multiplier;
+		return &mNumerics[varnum-1];
+	}
+	return var->sqldata;
+}
 
-		case SQL_TIMESTAMP :
-			if (ivType != ivTimestamp)
-				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			decodeTimestamp(*(IBPP::Timestamp*)retvalue, *(ISC_TIMESTAMP*)var->sqldata);
-			value = retvalue;
-			break;
+void* RowImpl::DecodeTimestamp(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivTimestamp)
+		throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	decodeTimestamp(*(IBPP::Timestamp*)retvalue, *(ISC_TIMESTAMP*)var->sqldata);
+	return retvalue;
+}
 
-		case SQL_TYPE_DATE :
-			if (ivType != ivDate)
-				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			decodeDate(*(IBPP::Date*)retvalue, *(ISC_DATE*)var->sqldata);
-			value = retvalue;
-			break;
+void* RowImpl::DecodeDate(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivDate)
+		throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	decodeDate(*(IBPP::Date*)retvalue, *(ISC_DATE*)var->sqldata);
+	return retvalue;
+}
 
-		case SQL_TYPE_TIME :
-			if (ivType != ivTime)
-				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			decodeTime(*(IBPP::Time*)retvalue, *(ISC_TIME*)var->sqldata);
-			value = retvalue;
-			break;
+void* RowImpl::DecodeTime(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivTime)
+		throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	decodeTime(*(IBPP::Time*)retvalue, *(ISC_TIME*)var->sqldata);
+	return retvalue;
+}
 
-		case SQL_BLOB :
-			if (ivType == ivBlob)
-			{
-				BlobImpl* blob = (BlobImpl*)retvalue;
-				blob->SetId((ISC_QUAD*)var->sqldata);
-				value = retvalue;
-			}
-			else if (ivType == ivString)
-			{
-				BlobImpl blob(mDatabase, mTransaction);
-				blob.SetId((ISC_QUAD*)var->sqldata);
-				std::string* str = (std::string*)retvalue;
-				blob.Load(*str);
-				value = retvalue;
-			}
-			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			break;
-			
-		case SQL_ARRAY :
-			if (ivType != ivArray)
-				throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
-											_("Incompatible types."));
-			{
-				ArrayImpl* array = (ArrayImpl*)retvalue;
-				array->SetId((ISC_QUAD*)var->sqldata);
-				value = retvalue;
-			}
-			break;
+void* RowImpl::DecodeBlob(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType == ivBlob)
+	{
+		BlobImpl* blob = (BlobImpl*)retvalue;
+		blob->SetId((ISC_QUAD*)var->sqldata);
+		return retvalue;
+	}
+	if (ivType == ivString)
+	{
+		BlobImpl blob(mDatabase, mTransaction);
+		blob.SetId((ISC_QUAD*)var->sqldata);
+		std::string* str = (std::string*)retvalue;
+		blob.Load(*str);
+		return retvalue;
+	}
+	throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+							_("Incompatible types."));
+}
 
-		case SQL_TIMESTAMP_TZ :
-			if (ivType != ivTimestamp)
-				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			decodeTimestampTz(*(IBPP::Timestamp*)retvalue, *(ISC_TIMESTAMP_TZ*)var->sqldata);
-			value = retvalue;
-			break;
+void* RowImpl::DecodeArray(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivArray)
+		throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	ArrayImpl* array = (ArrayImpl*)retvalue;
+	array->SetId((ISC_QUAD*)var->sqldata);
+	return retvalue;
+}
 
-		case SQL_TIME_TZ :
-			if (ivType != ivTime)
-				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
-										_("Incompatible types."));
-			decodeTimeTz(*(IBPP::Time*)retvalue, *(ISC_TIME_TZ*)var->sqldata);
-			value = retvalue;
-			break;
+void* RowImpl::DecodeTimestampTz(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivTimestamp)
+		throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	decodeTimestampTz(*(IBPP::Timestamp*)retvalue, *(ISC_TIMESTAMP_TZ*)var->sqldata);
+	return retvalue;
+}
 
-		default : throw LogicExceptionImpl("RowImpl::GetValue",
-						_("Found an unknown sqltype !"));
-	}
+void* RowImpl::DecodeTimeTz(int, XSQLVAR* var, IITYPE ivType, void* retvalue)
+{
+	if (ivType != ivTime)
+		throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+								_("Incompatible types."));
+	decodeTimeTz(*(IBPP::Time*)retvalue, *(ISC_TIME_TZ*)var->sqldata);
+	return retvalue;
+}
 
-	return value;
+void* RowImpl::DecodeUnknown(int, XSQLVAR*, IITYPE, void*)
+{
+	throw LogicExceptionImpl("RowImpl::GetValue",
+		_("Found an unknown sqltype !"));
 }
 
 void RowImpl::Free()
@@ -1537,6 +1537,8 @@ void RowImpl::Free()
 	mBools.clear();
 	mStrings.clear();
 	mUpdated.clear();
+	mDecoders.clear();
+	mColumnNums.clear();
 
 	mDialect = 0;
 	mDatabase = 0;
@@ -1633,6 +1635,7 @@ void RowImpl::AllocVariables()
 		}
 		if (var->sqltype & 1) var->sqlind = new short(-1);	// 0 indicator
 	}
+	BuildPlan();
 }
 
 bool RowImpl::MissingValues()
@@ -1700,6 +1703,8 @@ RowImpl& RowImpl::operator=(const RowImpl& copied)
 	mInt16s = copied.mInt16s;
 	mBools = copied.mBools;
 	mStrings = copied.mStrings;
+	mDecoders = copied.mDecoders;
+	mColumnNums = copied.mColumnNums;
 
 	mDialect = copied.mDialect;
 	mDatabase = copied.mDatabase;
@@ -412,6 +412,13 @@ int StatementImpl::AffectedRows()
 	return count;
 }
 
+//	Rows are fetched one at a time on purpose.  isc_dsql_fetch() is no
+//	network round trip per row: the remote client asks the server for a
+//	whole buffer of rows and serves the following calls from it.  The OO
+//	API offers nothing better, IResultSet::fetchNext() returns one row per
+//	call as well, so a multi-row fetch on top of it would only move this
+//	loop into IBPP while needing a second statement implementation.
+
 bool StatementImpl::Fetch()
 {
 	if (! mResultSetAvailable)
@@ -1148,6 +1155,14 @@ bool StatementImpl::Get(int column, std::string& retvalue)
 	return mOutRow->Get(column, retvalue);
 }
 
+bool StatementImpl::GetText(int column, const char*& text, int& length)
+{
+	if (mOutRow == 0)
+		throw LogicExceptionImpl("Statement::GetText", _("The row is not initialized."));
+
+	return mOutRow->GetText(column, text, length);
+}
+
 bool StatementImpl::Get(int column, int16_t* retvalue)
 {
 	if (mOutRow == 0)
@@ -33,6 +33,17 @@
 #include <wx/file.h>
 #include <wx/filename.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
 #include "config/DatabaseConfig.h"
 #include "core/StringUtils.h"
 #include "frversion.h"
@@ -41,47 +52,289 @@
 #include "sql/SqlStatement.h"
 #include "metadata/database.h"
 
-bool Logger::log2database(Config *cfg, const SqlStatement& stm, Database* db)
+namespace
 {
-    wxMBConv* conv = db->getCharsetConverter();
 
-    IBPP::Transaction tr = IBPP::TransactionFactory(db->getIBPPDatabase());
+// a statement to be logged in the FLAMEROBIN$LOG table, converted with the
+// character set of its database
+struct DatabaseLogEntry
+{
+    std::string databaseId;
+    // the attachment to use for the database, only set for the first entry
+    // of every database, as IBPP reference counting isn't thread-safe
+    IBPP::Database attachment;
+    std::string idSql;
+    bool hasObject;
+    std::string objectType;
+    std::string objectName;
+    std::string statement;
+};
+
+// inserts the logged statements into the database on a thread of its own,
+// so executing statements doesn't wait for the log; the statements are
+// inserted in one transaction per batch of up to maxBatch entries, which
+// are collected for up to maxDelay milliseconds
+class DatabaseLogQueue
+{
+private:
+    enum { maxBatch = 100, maxDelay = 500 };
+
+    std::mutex mutexM;
+    std::condition_variable changedM;
+    std::deque<DatabaseLogEntry> entriesM;
+    bool stopM;
+    std::thread threadM;
+    // ids of the databases whose attachment has been queued, only used
+    // on the main thread
+    std::set<std::string> databasesM;
+    // the attachments by database id, only used on the logging thread
+    std::map<std::string, IBPP::Database> attachmentsM;
+
+    void run();
+    void stop();
+    void write(std::vector<DatabaseLogEntry>& batch, size_t start,
+        size_t end);
+public:
+    DatabaseLogQueue();
+
+    void push(DatabaseLogEntry& entry, Database* db);
+    // writes all queued entries and releases the attachment of the
+    // database, the next entry creates a new one
+    void release(Database* db);
+    // writes all queued entries and stops the thread
+    void flush();
+};
+
+DatabaseLogQueue::DatabaseLogQueue()
+    : stopM(false)
+{
+}
+
+void DatabaseLogQueue::push(DatabaseLogEntry& entry, Database* db)
+{
+    entry.databaseId = wx2std(db->getId());
+    if (databasesM.find(entry.databaseId) == databasesM.end())
+    {
+        entry.attachment = db->createAttachment();
+        databasesM.insert(entry.databaseId);
+    }
+
+    std::lock_guard<std::mutex> lock(mutexM);
+    if (!threadM.joinable())
+        threadM = std::thread(&DatabaseLogQueue::run, this);
+    entriesM.push_back(entry);
+    // the queued entry holds the only reference now
+    entry.attachment = IBPP::Database();
+    changedM.notify_all();
+}
+
+// writes all queued entries and waits for the thread to finish, after
+// which the attachments may be used on the calling thread
+void DatabaseLogQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        stopM = true;
+        changedM.notify_all();
+    }
+    if (threadM.joinable())
+        threadM.join();
+    stopM = false;
+}
+
+void disconnectAttachment(IBPP::Database& attachment)
+{
     try
     {
-        tr->Start();
-        IBPP::Statement st = IBPP::StatementFactory(db->getIBPPDatabase(), tr);
+        if (attachment->Connected())
+            attachment->Disconnect();
+    }
+    catch (...)
+    {
+    }
+}
+
+void DatabaseLogQueue::release(Database* db)
+{
+    std::string databaseId(wx2std(db->getId()));
+    if (databasesM.erase(databaseId) == 0)
+        return;
+
+    // the thread is restarted by the next push()
+    stop();
+    std::map<std::string, IBPP::Database>::iterator it =
+        attachmentsM.find(databaseId);
+    if (it != attachmentsM.end())
+    {
+        disconnectAttachment((*it).second);
+        attachmentsM.erase(it);
+    }
+}
+
+void DatabaseLogQueue::flush()
+{
+    stop();
+    for (std::map<std::string, IBPP::Database>::iterator it =
+        attachmentsM.begin(); it != attachmentsM.end(); ++it)
+    {
+        disconnectAttachment((*it).second);
+    }
+    attachmentsM.clear();
+    databasesM.clear();
+}
+
+void DatabaseLogQueue::run()
+{
+    std::unique_lock<std::mutex> lock(mutexM);
+    while (true)
+    {
+        changedM.wait(lock, [this]() { return stopM || !entriesM.empty(); });
+        if (entriesM.empty())
+            break;
+        // give the following statements a chance to join this batch
+        changedM.wait_for(lock, std::chrono::milliseconds(maxDelay),
+            [this]() { return stopM || entriesM.size() >= maxBatch; });
 
-        // find next id
-        wxString sql = "SELECT gen_id(FLAMEROBIN$LOG_GEN, 1) FROM rdb$database";
-        if (cfg->get("LoggingUsesCustomSelect", false))
+        size_t count = std::min(entriesM.size(), size_t(maxBatch));
+        std::vector<DatabaseLogEntry> batch(entriesM.begin(),
+            entriesM.begin() + count);
+        entriesM.erase(entriesM.begin(), entriesM.begin() + count);
+        for (size_t i = 0; i < batch.size(); ++i)
         {
-            sql = cfg->get("LoggingCustomSelect",
-                wxString("SELECT 1+MAX(ID) FROM FLAMEROBIN$LOG"));
+            if (batch[i].attachment.intf() != 0)
+            {
+                attachmentsM[batch[i].databaseId] = batch[i].attachment;
+                batch[i].attachment = IBPP::Database();
+            }
         }
-        st->Prepare(wx2std(sql, conv));
-        st->Execute();
-        int cnt = 1;
-        if (st->Fetch() && !st->IsNull(1))
-            st->Get(1, cnt);
+        lock.unlock();
 
-        st->Prepare("INSERT INTO FLAMEROBIN$LOG (id, object_type, \
-            object_name, sql_statement) values (?,?,?,?)");
-        st->Set(1, cnt);
-        if (stm.isDDL())
+        // one transaction for all consecutive entries of a database
+        size_t start = 0;
+        for (size_t i = 1; i <= batch.size(); ++i)
         {
-            st->Set(2, wx2std(getNameOfType(stm.getObjectType()), conv));
-            st->Set(3, wx2std(stm.getName(), conv));
+            if (i == batch.size()
+                || batch[i].databaseId != batch[start].databaseId)
+            {
+                write(batch, start, i);
+                start = i;
+            }
         }
-        else
+        lock.lock();
+    }
+}
+
+void DatabaseLogQueue::write(std::vector<DatabaseLogEntry>& batch,
+    size_t start, size_t end)
+{
+    wxString error;
+    try
+    {
+        IBPP::Database& attachment = attachmentsM[batch[start].databaseId];
+        if (!attachment->Connected())
+            attachment->Connect();
+
+        IBPP::Transaction tr = IBPP::TransactionFactory(attachment);
+        tr->Start();
+        IBPP::Statement stId = IBPP::StatementFactory(attachment, tr);
+        IBPP::Statement stInsert = IBPP::StatementFactory(attachment, tr);
+        stInsert->Prepare("INSERT INTO FLAMEROBIN$LOG (id, object_type, \
+            object_name, sql_statement) values (?,?,?,?)");
+
+        std::string idSql;
+        for (size_t i = start; i < end; ++i)
         {
-            st->SetNull(2);
-            st->SetNull(3);
+            DatabaseLogEntry& entry = batch[i];
+
+            // find next id
+            if (entry.idSql != idSql)
+            {
+                idSql = entry.idSql;
+                stId->Prepare(idSql);
+            }
+            stId->Execute();
+            int cnt = 1;
+            if (stId->Fetch() && !stId->IsNull(1))
+                stId->Get(1, cnt);
+
+            stInsert->Set(1, cnt);
+            if (entry.hasObject)
+            {
+                stInsert->Set(2, entry.objectType);
+                stInsert->Set(3, entry.objectName);
+            }
+            else
+            {
+                stInsert->SetNull(2);
+                stInsert->SetNull(3);
+            }
+            IBPP::Blob bl = IBPP::BlobFactory(attachment, tr);
+            bl->Save(entry.statement);
+            stInsert->Set(4, bl);
+            stInsert->Execute();
         }
-        IBPP::Blob bl = IBPP::BlobFactory(st->DatabasePtr(), tr);
-        bl->Save(wx2std(stm.getStatement(), conv));
-        st->Set(4, bl);
-        st->Execute();
         tr->Commit();
+        return;
+    }
+    catch (IBPP::Exception &e)
+    {
+        error = wxString(e.what(), *wxConvCurrent);
+    }
+    catch (...)
+    {
+        error = _("Unexpected C++ exception");
+    }
+
+    // the statements of this batch are lost, tell the user without
+    // blocking this thread
+    if (wxTheApp)
+    {
+        wxTheApp->CallAfter([error]()
+        {
+            showWarningDialog(0, _("Logging to database failed"), error,
+                AdvancedMessageDialogButtonsOk());
+        });
+    }
+}
+
+DatabaseLogQueue& getDatabaseLogQueue()
+{
+    static DatabaseLogQueue queue;
+    return queue;
+}
+
+// files logged to in single file mode stay open, and the next number for
+// incremental file names is remembered, so only new names are probed
+std::map<wxString, std::unique_ptr<wxFile> > openLogFiles;
+std::map<wxString, int> nextLogFileNumbers;
+
+} // namespace
+
+bool Logger::log2database(Config *cfg, const SqlStatement& stm, Database* db)
+{
+    wxMBConv* conv = db->getCharsetConverter();
+
+    DatabaseLogEntry entry;
+    wxString sql = "SELECT gen_id(FLAMEROBIN$LOG_GEN, 1) FROM rdb$database";
+    if (cfg->get("LoggingUsesCustomSelect", false))
+    {
+        sql = cfg->get("LoggingCustomSelect",
+            wxString("SELECT 1+MAX(ID) FROM FLAMEROBIN$LOG"));
+    }
+    entry.idSql = wx2std(sql, conv);
+    entry.hasObject = stm.isDDL();
+    if (entry.hasObject)
+    {
+        entry.objectType = wx2std(getNameOfType(stm.getObjectType()), conv);
+        entry.objectName = wx2std(stm.getName(), conv);
+    }
+    entry.statement = wx2std(stm.getStatement(), conv);
+
+    try
+    {
+        // the statements are inserted on another thread, with an
+        // attachment of its own
+        getDatabaseLogQueue().push(entry, db);
         return true;
     }
     catch (IBPP::Exception &e)
@@ -116,7 +369,8 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
             sql += st.getTerminator();
     }
 
-    wxFile f;
+    wxFile multi;
+    wxFile* f = &multi;
     if (logToFileType == multiFile)
     {   // filename should contain stuff like: %d, %02d, %05d, etc.
         if (filename.find_last_of("%") == wxString::npos) // % not found
@@ -129,6 +383,10 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
         wxString test;
         int start = 1;
         cfg->getValue("IncrementalLogFileStart", start);
+        std::map<wxString, int>::iterator next =
+            nextLogFileNumbers.find(filename);
+        if (next != nextLogFileNumbers.end() && (*next).second > start)
+            start = (*next).second;
         for (int i=start; i < 100000; ++i) // dummy test for 100000
         {
             test.Printf(filename, i);
@@ -144,23 +402,34 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
 
             if (!wxFileExists(test))
             {
-                if (f.Open(test, wxFile::write))
+                if (multi.Open(test, wxFile::write))
+                {
+                    nextLogFileNumbers[filename] = i + 1;
                     break;
+                }
             }
         }
-        if (!f.IsOpened())
+        if (!multi.IsOpened())
         {
             showWarningDialog(0, _("Logging to file failed"),
                 _("Cannot open log file."), AdvancedMessageDialogButtonsOk());
             return false;
         }
     }
-    else if (!f.Open(filename, wxFile::write_append )) // cannot open
+    else
     {
-        showWarningDialog(0, _("Logging to file failed"),
-            _("Cannot open log file for writing."),
-            AdvancedMessageDialogButtonsOk());
-        return false;
+        std::unique_ptr<wxFile>& single = openLogFiles[filename];
+        if (!single)
+            single.reset(new wxFile());
+        if (!single->IsOpened()
+            && !single->Open(filename, wxFile::write_append)) // cannot open
+        {
+            showWarningDialog(0, _("Logging to file failed"),
+                _("Cannot open log file for writing."),
+                AdvancedMessageDialogButtonsOk());
+            return false;
+        }
+        f = single.get();
     }
 
     bool loggingAddHeader = true;
@@ -174,19 +443,30 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
             db->getUsername().c_str(),
             db->getPath().c_str()
         );
-        f.Write(header);
+        f->Write(header);
     }
     else
-        f.Write("\n");
+        f->Write("\n");
     if (logSetTerm && st.getTerminator() != ";")
-        f.Write("SET TERM " + st.getTerminator() + " ;\n");
-    f.Write(sql);
+        f->Write("SET TERM " + st.getTerminator() + " ;\n");
+    f->Write(sql);
     if (logSetTerm && st.getTerminator() != ";")
-        f.Write("\nSET TERM ; " + st.getTerminator() + "\n");
-    f.Close();
+        f->Write("\nSET TERM ; " + st.getTerminator() + "\n");
+    multi.Close();
     return true;
 }
 
+void Logger::releaseDatabase(Database* db)
+{
+    getDatabaseLogQueue().release(db);
+}
+
+void Logger::flush()
+{
+    getDatabaseLogQueue().flush();
+    openLogFiles.clear();
+}
+
 bool Logger::logStatement(const SqlStatement& st, Database* db)
 {
     DatabaseConfig dc(db, config());
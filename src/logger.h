@@ -41,6 +41,11 @@ private:
     static bool logStatementByConfig(Config *cfg, const SqlStatement& st, Database *db);
 public:
     static bool logStatement(const SqlStatement& st, Database *db);
+    // writes the queued statements of the database and releases its
+    // logging attachment, called when the database is disconnected or dropped
+    static void releaseDatabase(Database *db);
+    // writes the queued statements and closes the log files, called on exit
+    static void flush();
 };
 
 #endif
@@ -227,12 +227,16 @@ void SysCollations::acceptVisitor(MetadataItemVisitor* visitor)
 
 void SysCollations::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt(  " Select RDB$COLLATION_NAME "
-                    " from RDB$COLLATIONS  "
-                    " Order By RDB$COLLATION_NAME "
-    );
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysCollations::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back(" Select RDB$COLLATION_NAME "
+                         " from RDB$COLLATIONS  "
+                         " Order By RDB$COLLATION_NAME ");
+    return statements;
 }
 
 const wxString SysCollations::getTypeName() const
@@ -257,12 +261,17 @@ void Collations::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Collations::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt(" Select RDB$COLLATION_NAME "
+    loadItems(progressIndicator);
+}
+
+wxArrayString Collations::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back(" Select RDB$COLLATION_NAME "
         " from RDB$COLLATIONS  "
         " where RDB$SYSTEM_FLAG = 0 "
         " Order By RDB$COLLATION_NAME ");
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
+    return statements;
 }
 
 const wxString Collations::getTypeName() const
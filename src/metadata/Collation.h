@@ -88,6 +88,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -101,6 +102,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -242,16 +242,19 @@ void Indices::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Indices::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt = "select a.rdb$index_name from rdb$indices a "
+    loadItems(progressIndicator);
+}
+
+wxArrayString Indices::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
             " where (rdb$system_flag = 0 or rdb$system_flag is null) "
-            " order by 1 ";
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
-    
-    stmt = "select a.rdb$index_name from rdb$indices a "
+            " order by 1 ");
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
         " where (rdb$system_flag = 0 or rdb$system_flag is null) and a.rdb$index_inactive = 1 "
-        " order by 1 ";
-    setInactiveItems(db->loadIdentifiers(stmt, progressIndicator));
+        " order by 1 ");
+    return statements;
 }
 
 const wxString Indices::getTypeName() const
@@ -276,20 +279,23 @@ void SysIndices::acceptVisitor(MetadataItemVisitor* visitor)
 
 void SysIndices::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt = "select a.rdb$index_name from rdb$indices a "
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysIndices::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
         "   left join rdb$relation_constraints b on b.rdb$index_name = a.rdb$index_name "
         " where (rdb$system_flag = 0 or rdb$system_flag is null) "
         "   and b.rdb$index_name is not null "
-        " order by 1 ";
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
-
-    stmt = "select a.rdb$index_name from rdb$indices a "
+        " order by 1 ");
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
         "   left join rdb$relation_constraints b on b.rdb$index_name = a.rdb$index_name "
         " where (rdb$system_flag = 0 or rdb$system_flag is null) and a.rdb$index_inactive = 1 "
         "   and b.rdb$index_name is not null "
-        " order by 1 ";
-    setInactiveItems(db->loadIdentifiers(stmt, progressIndicator));
+        " order by 1 ");
+    return statements;
 }
 
 const wxString SysIndices::getTypeName() const
@@ -314,20 +320,23 @@ void UsrIndices::acceptVisitor(MetadataItemVisitor* visitor)
 
 void UsrIndices::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt = "select a.rdb$index_name from rdb$indices a "
+    loadItems(progressIndicator);
+}
+
+wxArrayString UsrIndices::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
         "   left join rdb$relation_constraints b on b.rdb$index_name = a.rdb$index_name "
         " where (rdb$system_flag = 0 or rdb$system_flag is null) "
         "   and b.rdb$index_name is null "
-        " order by 1 ";
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
-
-    stmt = "select a.rdb$index_name from rdb$indices a "
+        " order by 1 ");
+    statements.push_back("select a.rdb$index_name from rdb$indices a "
         "   left join rdb$relation_constraints b on b.rdb$index_name = a.rdb$index_name "
         " where (rdb$system_flag = 0 or rdb$system_flag is null) and a.rdb$index_inactive = 1 "
         "   and b.rdb$index_name is null "
-        " order by 1 ";
-    setInactiveItems(db->loadIdentifiers(stmt, progressIndicator));
+        " order by 1 ");
+    return statements;
 }
 
 
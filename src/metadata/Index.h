@@ -80,6 +80,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 
 };
@@ -94,6 +95,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -106,6 +108,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -61,10 +61,30 @@ public:
     virtual void handleTemplateCmd(TemplateProcessor *tp,
         const wxString& cmdName, const TemplateCmdParams& cmdParams,
         ProcessableObject* object, wxString& processedText);
+    virtual wxArrayString getCommandNames() const;
 };
 
 const MetadataTemplateCmdHandler MetadataTemplateCmdHandler::handlerInstance;
 
+wxArrayString MetadataTemplateCmdHandler::getCommandNames() const
+{
+    static const char* const names[] = {
+        "parent", "database", "object_handle", "object_name",
+        "object_quoted_name", "object_path", "object_type", "is_system",
+        "foreach", "owner_name", "object_description", "dependencyinfo",
+        "auxiliar", "primary_key", "no_pk_or_unique", "checkconstraintinfo",
+        "constraintinfo", "fkinfo", "columninfo", "viewinfo",
+        "procedureinfo", "triggerinfo", "generatorinfo", "exceptioninfo",
+        "udfinfo", "functioninfo", "indexinfo", "object_ddl", "dbinfo",
+        "privilegeinfo", "privilegeitemcount", "privilegeiteminfo",
+        "userinfo", "sql_security", "packageinfo", "collationinfo"
+    };
+    wxArrayString result;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        result.Add(names[i]);
+    return result;
+}
+
 void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
     const wxString& cmdName, const TemplateCmdParams& cmdParams,
     ProcessableObject* object, wxString& processedText)
@@ -24,8 +24,11 @@
 #ifndef FR_COLLECTION_H
 #define FR_COLLECTION_H
 
+#include <wx/hashmap.h>
+
 #include <algorithm>
 #include <iterator>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 
@@ -42,7 +45,7 @@ protected:
     {
     }
 
-    // helper structs for find_if()
+    // helper struct for find_if()
     struct FindByAddress
     {
         MetadataItem* itemM;
@@ -55,18 +58,6 @@ protected:
         }
     };
 
-    struct InsertionPosByName
-    {
-        wxString nameM;
-
-        InsertionPosByName(const wxString& name) : nameM(name) {}
-        bool operator()(const MetadataItemPtr item)
-        {
-            wxASSERT(item);
-            return item->getName_() > nameM;
-        }
-    };
-
 public:
     virtual DatabasePtr getDatabase() const
     {
@@ -74,6 +65,11 @@ public:
     }
 
     virtual bool isSystem() const { return false; }
+
+    // returns the statements reading the names of all items and the names
+    // of the inactive items (if any), empty for collections that load more
+    // than the names or are not supported by the ODS of the database
+    virtual wxArrayString getLoadStatements() const { return wxArrayString(); }
 };
 
 template <class T>
@@ -87,45 +83,98 @@ public:
 private:
     CollectionType itemsM;
 
-    iterator getPosition(const wxString& name)
+    // items by the text of their identifiers, maintained alongside itemsM
+    typedef std::unordered_map<wxString, ItemType, wxStringHash,
+        wxStringEqual> NameIndex;
+    NameIndex nameIndexM;
+    // items by metadata id, which is only known after the properties of an
+    // item have been loaded, so this is built on the first lookup after
+    // the collection has been changed or (re)loaded
+    typedef std::unordered_map<int, ItemType> IdIndex;
+    IdIndex idIndexM;
+    bool idIndexValidM;
+
+    void rebuildNameIndex()
     {
-        Identifier id(name);
+        nameIndexM.clear();
+        nameIndexM.reserve(itemsM.size());
         for (iterator it = itemsM.begin(); it != itemsM.end(); ++it)
+            nameIndexM.insert(std::make_pair((*it)->getIdentifier().get(), *it));
+        invalidateIdIndex();
+    }
+
+    void invalidateIdIndex()
+    {
+        idIndexM.clear();
+        idIndexValidM = false;
+    }
+
+    ItemType findInNameIndex(const wxString& name) const
+    {
+        typename NameIndex::const_iterator it =
+            nameIndexM.find(Identifier(name).get());
+        return (it != nameIndexM.end()) ? it->second : ItemType();
+    }
+
+    ItemType findInIdIndex(const int id)
+    {
+        if (!idIndexValidM)
         {
-            if ((*it)->getIdentifier().equals(id))
-                return it;
+            idIndexM.reserve(itemsM.size());
+            for (iterator item = itemsM.begin(); item != itemsM.end(); ++item)
+                idIndexM.insert(std::make_pair((*item)->getMetadataId(), *item));
+            idIndexValidM = true;
         }
-        return itemsM.end();
+        typename IdIndex::iterator it = idIndexM.find(id);
+        return (it != idIndexM.end()) ? it->second : ItemType();
     }
 
-    iterator getPositionMetadataId(const int id)
+    struct NameLess
     {
-        for (iterator it = itemsM.begin(); it != itemsM.end(); ++it)
+        bool operator()(const wxString& name, const ItemType& item) const
         {
-            if ((*it)->getMetadataId() == id)
-                return it;
+            return name < item->getName_();
         }
-        return itemsM.end();
-
-    }
+    };
 
 protected:
     MetadataCollection<T>(NodeType type, DatabasePtr database,
             const wxString& name)
-        : MetadataCollectionBase(type, database, name)
+        : MetadataCollectionBase(type, database, name), idIndexValidM(false)
     {
     }
 
+    // loads the items with the statements returned by getLoadStatements()
+    void loadItems(ProgressIndicator* progressIndicator)
+    {
+        wxArrayString statements(getLoadStatements());
+        DatabasePtr database = getDatabase();
+        if (statements.size() > 0)
+        {
+            setItems(database->loadIdentifiers(statements[0],
+                progressIndicator));
+        }
+        if (statements.size() > 1)
+        {
+            setInactiveItems(database->loadIdentifiers(statements[1],
+                progressIndicator));
+        }
+    }
+
 public:
     // inserts new item into list at correct position to preserve alphabetical
     // order of item names, and returns pointer to it
     ItemType insert(const wxString& name)
     {
-        iterator pos = std::find_if(itemsM.begin(), itemsM.end(),
-            InsertionPosByName(name));
+        // itemsM is sorted by name, so this is the first item with a name
+        // greater than the new one
+        iterator pos = std::upper_bound(itemsM.begin(), itemsM.end(), name,
+            NameLess());
         ItemType item(new T(getDatabase(), name));
         initializeLockCount(item, getLockCount());
         itemsM.insert(pos, item);
+        nameIndexM.insert(std::make_pair(item->getIdentifier().get(), item));
+        invalidateIdIndex();
         notifyObservers();
         return item;
     }
@@ -139,6 +188,11 @@ public:
             FindByAddress(item));
         if (pos != itemsM.end())
         {
+            typename NameIndex::iterator indexPos =
+                nameIndexM.find((*pos)->getIdentifier().get());
+            if (indexPos != nameIndexM.end() && indexPos->second == *pos)
+                nameIndexM.erase(indexPos);
+            invalidateIdIndex();
             itemsM.erase(pos);
             notifyObservers();
         }
@@ -148,18 +202,16 @@ public:
     {
         DatabasePtr database = getDatabase();
         CollectionType newItems;
+        newItems.reserve(names.size());
         for (size_t i = 0; i < names.size(); ++i)
         {
-            wxString itemName(names[i]);
-            iterator oldPos = getPosition(itemName);
-            if (oldPos == itemsM.end())
+            ItemType item(findInNameIndex(names[i]));
+            if (!item)
             {
-               ItemType item(new T(database, names[i]));
-                newItems.push_back(item);
+                item.reset(new T(database, names[i]));
                 initializeLockCount(item, getLockCount());
             }
-            else
-                newItems.push_back(*oldPos);
+            newItems.push_back(item);
         }
         setItems(newItems);
     }
@@ -180,8 +232,11 @@ public:
         if (itemsM != items)
         {
             itemsM = items;
+            rebuildNameIndex();
             notifyObservers();
         }
+        // the ids of the items may have been reloaded as well
+        invalidateIdIndex();
         setChildrenLoaded(true);
     }
 
@@ -209,20 +264,20 @@ public:
         if (!itemsM.empty())
         {
             itemsM.clear();
+            nameIndexM.clear();
+            invalidateIdIndex();
             notifyObservers();
         }
     };
 
     ItemType findByName(const wxString& name)
     {
-        iterator it = getPosition(name);
-        return (it != itemsM.end()) ? (*it) : ItemType();
+        return findInNameIndex(name);
     };
 
     ItemType findByMetadataId(const int id)
     {
-        iterator it = getPositionMetadataId(id);
-        return (it != itemsM.end()) ? (*it) : ItemType();
+        return findInIdIndex(id);
     }
 
     // returns vector of all subnodes
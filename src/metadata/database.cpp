@@ -31,14 +31,19 @@
 #endif
 
 #include <wx/encconv.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
 #include <wx/fontmap.h>
 
 #include <algorithm>
 #include <functional>
+#include <set>
 
 #include <thread>
 #include <future>
 #include <chrono>
+#include <atomic>
+#include <mutex>
 
 #include "config/Config.h"
 #include "config/DatabaseConfig.h"
@@ -46,6 +51,8 @@
 #include "core/ProgressIndicator.h"
 #include "core/StringUtils.h"
 #include "engine/MetadataLoader.h"
+#include "frutils.h"
+#include "logger.h"
 #include "MasterPassword.h"
 #include "metadata/CharacterSet.h"
 #include "metadata/column.h"
@@ -291,7 +298,9 @@ bool DatabaseAuthenticationMode::getUseEncryptedPassword() const
 // Database class
 Database::Database()
     : MetadataItem(ntDatabase), metadataLoaderM(0), connectedM(false),
-        connectionCredentialsM(0), dialectM(3), idM(0), volatileM(false)
+        connectionCredentialsM(0), dialectM(3), collectMetadataM(false),
+        uncachedMetadataLoadedM(false), metadataCacheValidationIdM(0),
+        idM(0), volatileM(false), timezoneIdOffsetM(0)
 {
     defaultTimezoneM.name = "";
     defaultTimezoneM.id = 0;
@@ -299,6 +308,7 @@ Database::Database()
 
 Database::~Database()
 {
+    stopMetadataCacheValidation();
     resetCredentials();
 }
 
@@ -368,24 +378,31 @@ void Database::getIdentifiers(std::vector<Identifier>& temp)
 }
 
 // This could be moved to Column class
-wxString Database::loadDomainNameForColumn(const wxString& table,
-    const wxString& field)
+std::vector<wxString> Database::loadDomainNamesForColumns(
+    const std::vector<std::pair<wxString, wxString> >& columns)
 {
     MetadataLoader* loader = getMetadataLoader();
     MetadataLoaderTransaction tr(loader);
     wxMBConv* converter = getCharsetConverter();
 
+    // the statement is prepared once for all columns
     IBPP::Statement& st1 = loader->getStatement(
         "select rdb$field_source from rdb$relation_fields"
         " where rdb$relation_name = ? and rdb$field_name = ?"
     );
-    st1->Set(1, wx2std(table, converter));
-    st1->Set(2, wx2std(field, converter));
-    st1->Execute();
-    st1->Fetch();
-    std::string domain;
-    st1->Get(1, domain);
-    return std2wxIdentifier(domain, converter);
+    std::vector<wxString> domains;
+    for (std::vector<std::pair<wxString, wxString> >::const_iterator it =
+        columns.begin(); it != columns.end(); ++it)
+    {
+        st1->Set(1, wx2std(it->first, converter));
+        st1->Set(2, wx2std(it->second, converter));
+        st1->Execute();
+        std::string domain;
+        if (st1->Fetch())
+            st1->Get(1, domain);
+        domains.push_back(std2wxIdentifier(domain, converter));
+    }
+    return domains;
 }
 
 void Database::getDatabaseTriggers(std::vector<Trigger *>& list)
@@ -488,24 +505,60 @@ void Database::loadCollations()
     }
 }
 
-wxString Database::getTableForIndex(const wxString& indexName)
+std::map<wxString, wxString> Database::getTablesForIndices(
+    const std::set<wxString>& indexNames)
 {
     MetadataLoader* loader = getMetadataLoader();
     MetadataLoaderTransaction tr(loader);
+    wxMBConv* converter = getCharsetConverter();
 
     IBPP::Statement& st1 = loader->getStatement(
         "SELECT rdb$relation_name from rdb$indices where rdb$index_name = ?");
-    st1->Set(1, wx2std(indexName, getCharsetConverter()));
-    st1->Execute();
+    std::map<wxString, wxString> tableNames;
+    for (std::set<wxString>::const_iterator it = indexNames.begin();
+        it != indexNames.end(); ++it)
+    {
+        st1->Set(1, wx2std(*it, converter));
+        st1->Execute();
+        if (st1->Fetch())
+        {
+            std::string s;
+            st1->Get(1, s);
+            tableNames[*it] = std2wxIdentifier(s, converter);
+        }
+    }
+    return tableNames;
+}
 
-    wxString tableName;
-    if (st1->Fetch())
+wxString Database::getRelationName(int relationId)
+{
+    std::map<int, wxString>::const_iterator it =
+        relationNamesM.find(relationId);
+    if (it != relationNamesM.end())
+        return (*it).second;
+
+    // (re)load the names of all relations, an unknown id may belong to a
+    // relation created since the names were loaded
+    relationNamesM.clear();
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+
+    IBPP::Statement& st1 = loader->getStatement(
+        "select rdb$relation_id, rdb$relation_name from rdb$relations");
+    st1->Execute();
+    while (st1->Fetch())
     {
+        int id;
         std::string s;
-        st1->Get(1, s);
-        tableName = std2wxIdentifier(s, getCharsetConverter());
+        st1->Get(1, id);
+        st1->Get(2, s);
+        relationNamesM[id] = std2wxIdentifier(s, getCharsetConverter());
     }
-    return tableName;
+
+    it = relationNamesM.find(relationId);
+    if (it != relationNamesM.end())
+        return (*it).second;
+    return wxEmptyString;
 }
 
 void Database::loadGeneratorValues()
@@ -518,13 +571,7 @@ void Database::loadGeneratorValues()
     MetadataLoaderTransaction tr(loader);
     SubjectLocker lock(this);
 
-    for (Generators::iterator it = generatorsM->begin();
-        it != generatorsM->end(); ++it)
-    {
-        // make sure generator value is reloaded from database
-        (*it)->invalidate();
-        (*it)->ensurePropertiesLoaded();
-    }
+    generatorsM->loadValues();
 }
 
 DatabasePtr Database::getDatabase() const
@@ -823,6 +870,52 @@ void Database::addObject(NodeType type, const wxString& name)
     }
 }
 
+// side effects of committed DDL statements that query the database or
+// notify observers; they are collected for all statements of a commit, so
+// that every object is reloaded and notified only once
+struct Database::CommitedDDL
+{
+    std::set<MetadataItem::Handle> notifyItems;
+    bool notifyDatabase;
+    bool notifyRelations;
+    bool reloadDMLTriggers;
+    std::set<wxString> changedIndices;
+    std::set<wxString> changedGenerators;
+    std::set<wxString> alteredDomains;
+    std::vector<std::pair<wxString, wxString> > alteredColumns;
+
+    CommitedDDL()
+        : notifyDatabase(false), notifyRelations(false),
+        reloadDMLTriggers(false)
+    {
+    }
+
+    void notify(MetadataItem* item)
+    {
+        if (item)
+            notifyItems.insert(item->getHandle());
+    }
+};
+
+void Database::parseCommitedSql(const SqlStatement& stm)
+{
+    std::vector<SqlStatement> statements;
+    statements.push_back(stm);
+    parseCommitedSql(statements);
+}
+
+void Database::parseCommitedSql(const std::vector<SqlStatement>& statements)
+{
+    SubjectLocker locker(this);
+    CommitedDDL ddl;
+    for (std::vector<SqlStatement>::const_iterator it = statements.begin();
+        it != statements.end(); ++it)
+    {
+        parseCommitedSql(*it, ddl);
+    }
+    applyCommitedDDL(ddl);
+}
+
 //! reads a DDL statement and acts accordingly
 //
 // drop [object_type] [name]
@@ -831,16 +924,17 @@ void Database::addObject(NodeType type, const wxString& name)
 // alter table [name] alter [column] type [domain or datatype]
 // declare external function [name]
 // set null flag via system tables update
-void Database::parseCommitedSql(const SqlStatement& stm)
+void Database::parseCommitedSql(const SqlStatement& stm, CommitedDDL& ddl)
 {
     if (!stm.isDDL())
         return;    // return false only on IBPP exception
 
+    // relations may have been created, dropped or recreated with a new id
+    relationNamesM.clear();
+
     if (stm.actionIs(actGRANT))
     {
-        MetadataItem *obj = stm.getObject();
-        if (obj)
-            obj->notifyObservers();
+        ddl.notify(stm.getObject());
         return;
     }
 
@@ -850,6 +944,7 @@ void Database::parseCommitedSql(const SqlStatement& stm)
         Tables::iterator it;
         for (it = tablesM->begin(); it != tablesM->end(); ++it)
             (*it)->invalidateIndices(stm.getName());
+        ddl.changedIndices.erase(stm.getName());
         return;
     }
 
@@ -857,31 +952,18 @@ void Database::parseCommitedSql(const SqlStatement& stm)
     if (stm.getObjectType() == ntIndex && ( stm.actionIs(actCREATE)
         || stm.actionIs(actALTER) || stm.actionIs(actSET)))
     {
-        wxString tableName = getTableForIndex(stm.getName());
-        MetadataItem* m = findByNameAndType(ntTable, tableName);
-        if (Table* t = dynamic_cast<Table*>(m))
-            t->invalidateIndices();
-
-        if (Index* i = dynamic_cast<Index*>(stm.getObject())) {
+        if (Index* i = dynamic_cast<Index*>(stm.getObject()))
             i->invalidate();
-            i->ensurePropertiesLoaded();
-            i->notifyObservers();
-        }
-        notifyObservers();
-
+        ddl.changedIndices.insert(stm.getName());
+        ddl.notifyDatabase = true;
         return;
     }
 
     // update all TABLEs, VIEWs and DATABASE on "DROP TRIGGER"
     if (stm.actionIs(actDROP, ntDMLTrigger))
     {
-        Tables::iterator itt;
-        for (itt = tablesM->begin(); itt != tablesM->end(); itt++)
-            (*itt)->notifyObservers();
-        Views::iterator itv;
-        for (itv = viewsM->begin(); itv != viewsM->end(); itv++)
-            (*itv)->notifyObservers();
-        notifyObservers();
+        ddl.notifyRelations = true;
+        ddl.notifyDatabase = true;
     }
 
     if (stm.actionIs(actCREATE) || stm.actionIs(actDECLARE))
@@ -890,9 +972,9 @@ void Database::parseCommitedSql(const SqlStatement& stm)
         // when trigger created: force relations to update their property pages
         Relation *r = stm.getCreateTriggerRelation();
         if (r)
-            r->notifyObservers();
+            ddl.notify(r);
         else if (stm.getObjectType() == ntDMLTrigger) // database trigger probably
-            notifyObservers();
+            ddl.notifyDatabase = true;
         return;
     }
 
@@ -907,29 +989,20 @@ void Database::parseCommitedSql(const SqlStatement& stm)
         {
             // make sure value is reloaded from database
             g->invalidate();
-            g->ensurePropertiesLoaded();
+            ddl.changedGenerators.insert(g->getName_());
         }
         return;
     }
 
     if (stm.actionIs(actDROP))
     {
+        if (stm.getObjectType() == ntGenerator)
+            ddl.changedGenerators.erase(object->getName_());
         dropObject(object);
+        // the triggers of the relation are gone as well, the trigger
+        // collection is reloaded once after all statements are processed
         if (stm.getObjectType() == ntTable || stm.getObjectType() == ntView)
-        {
-            DMLTriggers::iterator it = DMLtriggersM->begin();
-            while (it != DMLtriggersM->end())
-            {
-                Relation* r = getRelationForTrigger((*it).get());
-                if (!r || r->getIdentifier().equals(stm.getIdentifier()))
-                {
-                    dropObject((*it).get());
-                    it = DMLtriggersM->begin();
-                }
-                else
-                    it++;
-            }
-        }
+            ddl.reloadDMLTriggers = true;
         return;
     }
 
@@ -937,22 +1010,8 @@ void Database::parseCommitedSql(const SqlStatement& stm)
     {
         if (stm.isDatatype())
         {
-            wxString domainName(loadDomainNameForColumn(stm.getName(),
-                stm.getFieldName()));
-            if (MetadataItem::hasSystemPrefix(domainName))
-            {
-                DomainPtr d = sysDomainsM->findByName(domainName);
-                if (!d)     // domain does not exist in DBH
-                    d = sysDomainsM->insert(domainName);
-                d->invalidate();
-            }
-            else
-            {
-                DomainPtr d = userDomainsM->findByName(domainName);
-                if (!d)     // domain does not exist in DBH
-                    d = userDomainsM->insert(domainName);
-                d->invalidate();
-            }
+            ddl.alteredColumns.push_back(
+                std::make_pair(stm.getName(), stm.getFieldName()));
         }
         else
         {
@@ -980,23 +1039,12 @@ void Database::parseCommitedSql(const SqlStatement& stm)
                 dynamic_cast<Procedure*>(object)->checkDependentProcedures();
                 break;
             case ntDDLTrigger:
-            {
-                DDLTrigger* tr = dynamic_cast<DDLTrigger*>(object);
-                tr->invalidate();
-                tr->ensurePropertiesLoaded();
-                tr->notifyObservers();
-                notifyObservers();
-                break;
-            }
             case ntDBTrigger:
-            {
-                DBTrigger* tr = dynamic_cast<DBTrigger*>(object);
-                tr->invalidate();
-                tr->ensurePropertiesLoaded();
-                tr->notifyObservers();
-                notifyObservers();
+                // properties are reloaded before the observers are notified
+                object->invalidate();
+                ddl.notify(object);
+                ddl.notifyDatabase = true;
                 break;
-            }
             case ntDMLTrigger:
             {
                 DMLTrigger* tr = dynamic_cast<DMLTrigger*>(object);
@@ -1005,38 +1053,134 @@ void Database::parseCommitedSql(const SqlStatement& stm)
                     tr->invalidate();
                     Relation* r = getRelationForTrigger(tr);
                     if (r)
-                        r->notifyObservers();
+                        ddl.notify(r);
                     else  // database trigger
-                        notifyObservers();
+                        ddl.notifyDatabase = true;
                 }
                 break;
             }
             case ntDomain:
                 object->invalidate();
-                // notify all table columns with that domain
-                for (Tables::iterator it = tablesM->begin();
-                    it != tablesM->end(); ++it)
-                {
-                    for (ColumnPtrs::iterator itColumn = (*it)->begin();
-                        itColumn != (*it)->end(); ++itColumn)
-                    {
-                        if ((*itColumn)->getSource() == stm.getName())
-                            (*itColumn)->invalidate();
-                    }
-                }
+                // table columns with that domain are invalidated in one pass
+                ddl.alteredDomains.insert(stm.getName());
                 break;
             default:
                 // calls notifyObservers() only in the base class
                 // descendent classes are free to put there whatever it takes...
                 object->invalidate();
-                object->notifyObservers();
+                ddl.notify(object);
                 //object->ensurePropertiesLoaded();
-                notifyObservers();
+                ddl.notifyDatabase = true;
                 break;
         }
     }
 }
 
+void Database::applyCommitedDDL(CommitedDDL& ddl)
+{
+    if (ddl.reloadDMLTriggers)
+    {
+        // a single query instead of loading the relation of every trigger
+        DMLtriggersM->load(0);
+    }
+
+    if (!ddl.changedIndices.empty())
+    {
+        std::map<wxString, wxString> tableNames(
+            getTablesForIndices(ddl.changedIndices));
+        for (std::set<wxString>::const_iterator it =
+            ddl.changedIndices.begin(); it != ddl.changedIndices.end(); ++it)
+        {
+            MetadataItem* m = findByNameAndType(ntTable, tableNames[*it]);
+            if (Table* t = dynamic_cast<Table*>(m))
+                t->invalidateIndices();
+            if (Index* i = dynamic_cast<Index*>(
+                findByNameAndType(ntIndex, *it)))
+            {
+                i->ensurePropertiesLoaded();
+                ddl.notify(i);
+            }
+        }
+    }
+
+    if (ddl.changedGenerators.size() > 1)
+        generatorsM->loadValues();
+    else if (!ddl.changedGenerators.empty())
+    {
+        if (GeneratorPtr g = generatorsM->findByName(
+            *ddl.changedGenerators.begin()))
+        {
+            g->ensurePropertiesLoaded();
+        }
+    }
+
+    if (!ddl.alteredColumns.empty())
+    {
+        std::vector<wxString> domainNames(
+            loadDomainNamesForColumns(ddl.alteredColumns));
+        for (std::vector<wxString>::const_iterator it = domainNames.begin();
+            it != domainNames.end(); ++it)
+        {
+            if (it->empty())
+                continue;
+            if (MetadataItem::hasSystemPrefix(*it))
+            {
+                DomainPtr d = sysDomainsM->findByName(*it);
+                if (!d)     // domain does not exist in DBH
+                    d = sysDomainsM->insert(*it);
+                d->invalidate();
+            }
+            else
+            {
+                DomainPtr d = userDomainsM->findByName(*it);
+                if (!d)     // domain does not exist in DBH
+                    d = userDomainsM->insert(*it);
+                d->invalidate();
+            }
+        }
+    }
+
+    if (!ddl.alteredDomains.empty())
+    {
+        // invalidate all table columns with one of the altered domains
+        for (Tables::iterator it = tablesM->begin();
+            it != tablesM->end(); ++it)
+        {
+            for (ColumnPtrs::iterator itColumn = (*it)->begin();
+                itColumn != (*it)->end(); ++itColumn)
+            {
+                if (ddl.alteredDomains.count((*itColumn)->getSource()))
+                    (*itColumn)->invalidate();
+            }
+        }
+    }
+
+    if (ddl.notifyRelations)
+    {
+        Tables::iterator itt;
+        for (itt = tablesM->begin(); itt != tablesM->end(); itt++)
+            (*itt)->notifyObservers();
+        Views::iterator itv;
+        for (itv = viewsM->begin(); itv != viewsM->end(); itv++)
+            (*itv)->notifyObservers();
+    }
+
+    // items dropped by a later statement of the batch are no longer found
+    for (std::set<MetadataItem::Handle>::const_iterator it =
+        ddl.notifyItems.begin(); it != ddl.notifyItems.end(); ++it)
+    {
+        MetadataItem* item;
+        if (!MetadataItem::findObjectFromHandle(*it, item))
+            continue;
+        if (item->getType() == ntDDLTrigger || item->getType() == ntDBTrigger)
+            item->ensurePropertiesLoaded();
+        item->notifyObservers();
+    }
+
+    if (ddl.notifyDatabase)
+        notifyObservers();
+}
+
 void Database::create(int pagesize, int dialect)
 {
     wxString extra_params;
@@ -1060,6 +1204,8 @@ void Database::create(int pagesize, int dialect)
 
 void Database::drop()
 {
+    // the attachment used for logging would prevent dropping
+    Logger::releaseDatabase(this);
     databaseM->Drop();
     setDisconnected();
 }
@@ -1094,14 +1240,7 @@ void Database::connect(const wxString& password, ProgressIndicator* indicator)
         databaseM.clear();
 
         auto connect = [this, &password]() {
-            bool useUserNamePwd = !authenticationModeM.getIgnoreUsernamePassword();
-            IBPP::Database db = IBPP::DatabaseFactory("",
-                wx2std(getConnectionString()),
-                (useUserNamePwd ? wx2std(getUsername()) : ""),
-                (useUserNamePwd ? wx2std(password) : ""),
-                wx2std(getRole()), wx2std(getConnectionCharset()), 
-                "", wx2std(getClientLibrary())
-            );
+            IBPP::Database db = createIBPPDatabase(password);
             db->Connect();  // As standard, will block for 180 seconds or until connected
             return db;
         };
@@ -1228,8 +1367,7 @@ void Database::connect(const wxString& password, ProgressIndicator* indicator)
 
                 // load collections of metadata objects
                 setChildrenLoaded(false);
-                loadCollections(indicator);
-                setChildrenLoaded(true);
+                loadMetadata(indicator, std::map<std::string, std::string>());
                 if (indicator)
                     indicator->initProgress(_("Complete"), 1, 1);
             }
@@ -1254,6 +1392,78 @@ void Database::connect(const wxString& password, ProgressIndicator* indicator)
     }
 }
 
+IBPP::Database Database::createIBPPDatabase(const wxString& password)
+{
+    bool useUserNamePwd = !authenticationModeM.getIgnoreUsernamePassword();
+    return IBPP::DatabaseFactory("",
+        wx2std(getConnectionString()),
+        (useUserNamePwd ? wx2std(getUsername()) : ""),
+        (useUserNamePwd ? wx2std(password) : ""),
+        wx2std(getRole()), wx2std(getConnectionCharset()),
+        "", wx2std(getClientLibrary())
+    );
+}
+
+// loads the collections, and the details of all relations if they are
+// prefetched; with the metadata cache enabled the item names and details
+// are taken from the cache, either all of them if the fingerprints aren't
+// known yet (they are then checked in the background) or only those read
+// from system tables that have not been changed since
+void Database::loadMetadata(ProgressIndicator* progressIndicator,
+    std::map<std::string, std::string> fingerprints)
+{
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    SubjectLocker lock(this);
+
+    // the metadata read while loading is kept until everything is loaded,
+    // to be written to the metadata cache
+    struct LoadedMetadataReset
+    {
+        Database* databaseM;
+        LoadedMetadataReset(Database* database)
+            : databaseM(database) {}
+        ~LoadedMetadataReset()
+        {
+            databaseM->collectMetadataM = false;
+            databaseM->loadedIdentifiersM.clear();
+            databaseM->loadedRowsM.clear();
+        }
+    };
+    LoadedMetadataReset loadedMetadataReset(this);
+
+    bool useCache = useMetadataCache();
+    bool validateCache = false;
+    std::map<std::string, std::string> cachedFingerprints;
+    if (useCache && readMetadataCache(cachedFingerprints))
+    {
+        if (fingerprints.empty())
+        {
+            validateCache = true;
+            fingerprints = cachedFingerprints;
+        }
+        else
+            dropChangedMetadata(cachedFingerprints, fingerprints);
+    }
+    else if (useCache && fingerprints.empty())
+        fingerprints = loadMetadataFingerprints();
+    collectMetadataM = true;
+    uncachedMetadataLoadedM = false;
+
+    loadCollections(progressIndicator);
+    setChildrenLoaded(true);
+    if (prefetchRelationDetails())
+        loadRelationDetails(progressIndicator);
+
+    if (useCache && !fingerprints.empty()
+        && (uncachedMetadataLoadedM || !validateCache))
+    {
+        writeMetadataCache(fingerprints);
+    }
+    if (validateCache)
+        startMetadataCacheValidation(cachedFingerprints);
+}
+
 void Database::loadCollections(ProgressIndicator* progressIndicator)
 {
     // use a small helper to cut down on the repetition...
@@ -1283,6 +1493,51 @@ void Database::loadCollections(ProgressIndicator* progressIndicator)
     MetadataLoaderTransaction tr(loader);
     SubjectLocker lock(this);
 
+    // prefetched item names are kept by loadMetadata() for the metadata
+    // cache, otherwise they are only used for this load
+    struct PrefetchedIdentifiersReset
+    {
+        Database* databaseM;
+        PrefetchedIdentifiersReset(Database* database)
+            : databaseM(database) {}
+        ~PrefetchedIdentifiersReset()
+        {
+            if (!databaseM->collectMetadataM)
+                databaseM->loadedIdentifiersM.clear();
+        }
+    };
+    PrefetchedIdentifiersReset prefetchedIdentifiersReset(this);
+
+    if (loadCollectionsConcurrently())
+    {
+        // read the item names of all collections that support it over
+        // several attachments at once, the collections below are then
+        // loaded from those results without further round trips
+        MetadataCollectionBase* collections[] = { tablesM.get(),
+            sysTablesM.get(), GTTablesM.get(), viewsM.get(),
+            proceduresM.get(), DMLtriggersM.get(), rolesM.get(),
+            sysRolesM.get(), userDomainsM.get(), functionSQLsM.get(),
+            UDFsM.get(), generatorsM.get(), exceptionsM.get(),
+            packagesM.get(), sysPackagesM.get(), DBTriggersM.get(),
+            DDLTriggersM.get(), sysDomainsM.get(), indicesM.get(),
+            sysIndicesM.get(), usrIndicesM.get(), characterSetsM.get(),
+            collationsM.get() };
+
+        std::vector<std::string> statements;
+        for (MetadataCollectionBase* collection : collections)
+        {
+            wxArrayString loadStatements(collection->getLoadStatements());
+            for (size_t i = 0; i < loadStatements.size(); ++i)
+            {
+                std::string sql(wx2std(loadStatements[i],
+                    getCharsetConverter()));
+                if (loadedIdentifiersM.find(sql) == loadedIdentifiersM.end())
+                    statements.push_back(sql);
+            }
+        }
+        prefetchIdentifiers(statements, progressIndicator);
+    }
+
     pih.init(_("tables"), collectionCount, 0);
     tablesM->load(progressIndicator);
 
@@ -1361,7 +1616,102 @@ void Database::loadCollections(ProgressIndicator* progressIndicator)
 
     pih.init(_("User Collations"), collectionCount, 22);
     collationsM->load(progressIndicator);
+}
 
+void Database::prefetchIdentifiers(const std::vector<std::string>& statements,
+    ProgressIndicator* progressIndicator)
+{
+    const size_t maxWorkers = 4;
+    size_t workerCount = std::min(maxWorkers, statements.size());
+    if (workerCount == 0)
+        return;
+
+    // the attachments are created here, as the worker threads must not
+    // access this object
+    std::vector<IBPP::Database> attachments;
+    wxString password(databaseM->UserPassword());
+    for (size_t i = 0; i < workerCount; ++i)
+        attachments.push_back(createIBPPDatabase(password));
+
+    std::vector<std::vector<std::string> > results(statements.size());
+    std::atomic<size_t> nextStatement(0);
+    std::atomic<size_t> statementsDone(0);
+    std::atomic<size_t> workersRunning(workerCount);
+    std::atomic<bool> stop(false);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    // every worker uses its own attachment and read-only transaction, and
+    // executes the next statement not yet taken by another worker
+    auto worker = [&](IBPP::Database& attachment)
+    {
+        try
+        {
+            attachment->Connect();
+            {
+                MetadataLoader loader(attachment);
+                MetadataLoaderTransaction tr(&loader);
+                for (size_t i = nextStatement++;
+                    i < statements.size() && !stop; i = nextStatement++)
+                {
+                    IBPP::Statement& st = loader.getStatement(statements[i]);
+                    st->Execute();
+                    while (st->Fetch())
+                    {
+                        if (!st->IsNull(1))
+                        {
+                            std::string s;
+                            st->Get(1, s);
+                            results[i].push_back(s);
+                        }
+                    }
+                    ++statementsDone;
+                }
+            }
+            attachment->Disconnect();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            stop = true;
+        }
+        --workersRunning;
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workerCount; ++i)
+        workers.push_back(std::thread(worker, std::ref(attachments[i])));
+
+    bool canceled = false;
+    while (workersRunning > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (progressIndicator && !canceled)
+        {
+            progressIndicator->initProgress(_("Loading metadata collections..."),
+                statements.size(), statementsDone, 1);
+            if (progressIndicator->isCanceled())
+            {
+                // running statements are not interrupted, but no new ones
+                // will be started
+                canceled = true;
+                stop = true;
+            }
+        }
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+
+    if (canceled)
+        throw CancelProgressException();
+    if (error)
+        std::rethrow_exception(error);
+
+    for (size_t i = 0; i < statements.size(); ++i)
+        loadedIdentifiersM[statements[i]].swap(results[i]);
+    uncachedMetadataLoadedM = true;
 }
 
 void Database::loadDatabaseInfo()
@@ -1406,15 +1756,26 @@ void Database::loadDatabaseInfo()
 wxArrayString Database::loadIdentifiers(const wxString& loadStatement,
     ProgressIndicator* progressIndicator)
 {
+    wxMBConv* converter = getCharsetConverter();
+    std::string sql(wx2std(loadStatement, converter));
+
+    wxArrayString names;
+    std::map<std::string, std::vector<std::string> >::iterator it =
+        loadedIdentifiersM.find(sql);
+    if (it != loadedIdentifiersM.end())
+    {
+        for (size_t i = 0; i < it->second.size(); ++i)
+            names.push_back(std2wxIdentifier(it->second[i], converter));
+        return names;
+    }
+
     MetadataLoader* loader = getMetadataLoader();
     MetadataLoaderTransaction tr(loader);
-    wxMBConv* converter = getCharsetConverter();
 
-    IBPP::Statement& st1 = loader->getStatement(
-        wx2std(loadStatement, getCharsetConverter()));
+    IBPP::Statement& st1 = loader->getStatement(sql);
     st1->Execute();
 
-    wxArrayString names;
+    std::vector<std::string> identifiers;
     while (st1->Fetch())
     {
         checkProgressIndicatorCanceled(progressIndicator);
@@ -1423,11 +1784,560 @@ wxArrayString Database::loadIdentifiers(const wxString& loadStatement,
             std::string s;
             st1->Get(1, s);
             names.push_back(std2wxIdentifier(s, converter));
+            if (collectMetadataM)
+                identifiers.push_back(s);
         }
     }
+    if (collectMetadataM)
+    {
+        uncachedMetadataLoadedM = true;
+        loadedIdentifiersM[sql].swap(identifiers);
+    }
     return names;
 }
 
+wxString Database::getMetadataCacheFileName()
+{
+    wxString path = config().getUserHomePath() + "metadata-cache"
+        + wxFileName::GetPathSeparator();
+    if (!wxDirExists(path))
+        wxMkdir(path);
+    return path + "DATABASE" + getId() + ".cache";
+}
+
+namespace
+{
+    // reads the fingerprints with a statement built by
+    // getMetadataFingerprintsStatement(), from any thread
+    std::map<std::string, std::string> readMetadataFingerprints(
+        MetadataLoader& loader, const std::string& sql)
+    {
+        MetadataLoaderTransaction tr(&loader);
+
+        std::map<std::string, std::string> fingerprints;
+        IBPP::Statement st1 = loader.createStatement(sql);
+        st1->Execute();
+        while (st1->Fetch())
+        {
+            std::string table;
+            int64_t count = 0, hashes = 0;
+            st1->Get(1, table);
+            st1->Get(2, count);
+            if (!st1->IsNull(3))
+                st1->Get(3, hashes);
+            fingerprints[table] = std::to_string(count) + ":"
+                + std::to_string(hashes);
+        }
+        return fingerprints;
+    }
+}
+
+std::string Database::getMetadataFingerprintsStatement()
+{
+    // number of rows and sum of item hashes of each system table the
+    // collections and relation details are loaded from; the name of every
+    // item is hashed together with the columns that decide which collection
+    // it goes to and whether it is inactive, so an object recreated as
+    // another kind of object under the same name changes the fingerprint
+    // too, and with the columns (sources and descriptions as hashes) read
+    // into the relation details; index statistics are not part of it
+    const bool ods11_1 = getInfo().getODSVersionIsHigherOrEqualTo(11, 1);
+    const bool ods12 = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+    auto itemHash = [](const std::string& name,
+        const std::vector<std::string>& columns)
+    {
+        std::string expression("hash(" + name);
+        for (const std::string& column : columns)
+            expression += " || '|' || " + column;
+        return expression + ")";
+    };
+    auto blobHash = [](const std::string& column)
+    {
+        return "coalesce(hash(" + column + "), 0)";
+    };
+    const std::string systemFlag("coalesce(rdb$system_flag, 0)");
+    const std::string packageName("coalesce(rdb$package_name, '')");
+
+    std::vector<std::string> relationColumns = { systemFlag,
+        "iif(rdb$view_blr is null, 0, 1)" };
+    if (ods11_1)
+        relationColumns.push_back("coalesce(rdb$relation_type, 0)");
+    relationColumns.push_back(blobHash("rdb$description"));
+    std::vector<std::string> relationFieldColumns = { "rdb$field_name",
+        "rdb$field_source", "coalesce(rdb$null_flag, 0)",
+        "coalesce(rdb$field_position, 0)", "coalesce(rdb$collation_id, -1)",
+        blobHash("rdb$default_source"), blobHash("rdb$description") };
+    std::vector<std::string> procedureColumns = { systemFlag };
+    std::vector<std::string> functionColumns = { systemFlag };
+    std::vector<std::string> generatorColumns = { systemFlag };
+    if (ods12)
+    {
+        relationFieldColumns.push_back("coalesce(rdb$identity_type, -1)");
+        relationFieldColumns.push_back("coalesce(rdb$generator_name, '')");
+        procedureColumns.push_back(packageName);
+        functionColumns.push_back(packageName);
+        functionColumns.push_back("coalesce(rdb$legacy_flag, 0)");
+        generatorColumns.push_back("coalesce(rdb$initial_value, 0)");
+        generatorColumns.push_back("coalesce(rdb$generator_increment, 0)");
+    }
+    std::vector<std::string> roleColumns;
+    if (ods11_1)
+        roleColumns.push_back(systemFlag);
+
+    typedef std::pair<std::string, std::string> SystemTable;
+    std::vector<SystemTable> tables = {
+        { "RDB$RELATIONS", itemHash("rdb$relation_name", relationColumns) },
+        { "RDB$RELATION_FIELDS",
+            itemHash("rdb$relation_name", relationFieldColumns) },
+        { "RDB$PROCEDURES",
+            itemHash("rdb$procedure_name", procedureColumns) },
+        { "RDB$TRIGGERS", itemHash("rdb$trigger_name", { systemFlag,
+            "coalesce(rdb$trigger_inactive, 0)",
+            "coalesce(rdb$trigger_type, 0)",
+            "coalesce(rdb$relation_name, '')",
+            blobHash("rdb$trigger_source") }) },
+        { "RDB$ROLES", itemHash("rdb$role_name", roleColumns) },
+        { "RDB$FIELDS", itemHash("rdb$field_name", { systemFlag,
+            blobHash("rdb$computed_source") }) },
+        { "RDB$FUNCTIONS", itemHash("rdb$function_name", functionColumns) },
+        { "RDB$GENERATORS",
+            itemHash("rdb$generator_name", generatorColumns) },
+        { "RDB$INDICES", itemHash("rdb$index_name", { systemFlag,
+            "coalesce(rdb$index_inactive, 0)",
+            "coalesce(rdb$relation_name, '')",
+            "coalesce(rdb$unique_flag, 0)", "coalesce(rdb$index_type, 0)",
+            blobHash("rdb$expression_source") }) },
+        { "RDB$INDEX_SEGMENTS", itemHash("rdb$index_name",
+            { "rdb$field_name", "coalesce(rdb$field_position, 0)" }) },
+        { "RDB$RELATION_CONSTRAINTS", itemHash("rdb$constraint_name",
+            { "coalesce(rdb$index_name, '')", "rdb$constraint_type",
+            "rdb$relation_name" }) },
+        { "RDB$REF_CONSTRAINTS", itemHash("rdb$constraint_name",
+            { "coalesce(rdb$const_name_uq, '')",
+            "coalesce(rdb$update_rule, '')",
+            "coalesce(rdb$delete_rule, '')" }) },
+        { "RDB$CHECK_CONSTRAINTS", itemHash("rdb$constraint_name",
+            { "coalesce(rdb$trigger_name, '')" }) },
+        { "RDB$DEPENDENCIES", itemHash("rdb$dependent_name",
+            { "rdb$depended_on_name", "coalesce(rdb$field_name, '')",
+            "rdb$depended_on_type" }) },
+        { "RDB$COLLATIONS",
+            itemHash("rdb$collation_name", { systemFlag }) }
+    };
+    if (ods12)
+    {
+        tables.push_back(SystemTable("RDB$PACKAGES",
+            itemHash("rdb$package_name", { systemFlag })));
+    }
+
+    std::string sql;
+    for (const SystemTable& table : tables)
+    {
+        if (!sql.empty())
+            sql += " union all ";
+        sql += "select cast('" + table.first
+            + "' as varchar(31)), count(*), sum(mod("
+            + table.second + ", 1000003)) from " + table.first;
+    }
+    return sql;
+}
+
+std::map<std::string, std::string> Database::loadMetadataFingerprints()
+{
+    try
+    {
+        return readMetadataFingerprints(*getMetadataLoader(),
+            getMetadataFingerprintsStatement());
+    }
+    catch (IBPP::Exception&)
+    {
+        // hash() needs Firebird 2.1, older servers don't use the cache
+        return std::map<std::string, std::string>();
+    }
+}
+
+namespace
+{
+    void appendCacheString(std::string& data, const std::string& s)
+    {
+        data += std::to_string(s.size());
+        data += ':';
+        data += s;
+        data += '\n';
+    }
+
+    bool readCacheString(const std::string& data, size_t& pos,
+        std::string& s)
+    {
+        size_t colon = data.find(':', pos);
+        if (colon == std::string::npos || colon == pos)
+            return false;
+        size_t length = 0;
+        for (size_t i = pos; i < colon; ++i)
+        {
+            if (data[i] < '0' || data[i] > '9')
+                return false;
+            length = 10 * length + (data[i] - '0');
+        }
+        if (colon + 1 + length >= data.size()
+            || data[colon + 1 + length] != '\n')
+        {
+            return false;
+        }
+        s = data.substr(colon + 1, length);
+        pos = colon + 2 + length;
+        return true;
+    }
+
+    bool readCacheCount(const std::string& data, size_t& pos, size_t& count)
+    {
+        std::string s;
+        if (!readCacheString(data, pos, s) || s.empty()
+            || s.find_first_not_of("0123456789") != std::string::npos)
+        {
+            return false;
+        }
+        count = std::stoul(s);
+        return true;
+    }
+
+    // values of cached rows are prefixed with '-' if null, '+' otherwise
+    void appendCacheValue(std::string& data, const MetadataRows::Value& v)
+    {
+        appendCacheString(data, (v.isNull ? "-" : "+") + v.data);
+    }
+
+    bool readCacheValue(const std::string& data, size_t& pos,
+        MetadataRows::Value& v)
+    {
+        std::string s;
+        if (!readCacheString(data, pos, s) || s.empty()
+            || (s[0] != '-' && s[0] != '+'))
+        {
+            return false;
+        }
+        v.isNull = s[0] == '-';
+        v.data = s.substr(1);
+        return true;
+    }
+
+    // returns whether the statement reads from the (system) table
+    bool statementUsesTable(const std::string& sql, const std::string& table)
+    {
+        std::string lowerSql(sql), lowerTable(table);
+        std::transform(lowerSql.begin(), lowerSql.end(), lowerSql.begin(),
+            ::tolower);
+        std::transform(lowerTable.begin(), lowerTable.end(),
+            lowerTable.begin(), ::tolower);
+        for (size_t pos = lowerSql.find(lowerTable); pos != std::string::npos;
+            pos = lowerSql.find(lowerTable, pos + 1))
+        {
+            size_t end = pos + lowerTable.size();
+            if (end == lowerSql.size()
+                || !(isalnum((unsigned char)lowerSql[end]) || lowerSql[end] == '_'
+                    || lowerSql[end] == '$'))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // returns whether the statement reads from known system tables, none
+    // of which are among the changed tables
+    bool statementUnchanged(const std::string& sql,
+        const std::map<std::string, std::string>& fingerprints,
+        const std::set<std::string>& changedTables)
+    {
+        bool valid = false;
+        for (std::map<std::string, std::string>::const_iterator it =
+            fingerprints.begin(); it != fingerprints.end(); ++it)
+        {
+            if (statementUsesTable(sql, it->first))
+            {
+                if (changedTables.count(it->first))
+                    return false;
+                valid = true;
+            }
+        }
+        return valid;
+    }
+
+    const char* metadataCacheHeader = "FlameRobin metadata cache 2";
+}
+
+bool Database::readMetadataCache(
+    std::map<std::string, std::string>& fingerprints)
+{
+    loadedIdentifiersM.clear();
+    loadedRowsM.clear();
+
+    wxString fileName(getMetadataCacheFileName());
+    if (!wxFileExists(fileName))
+        return false;
+    wxLogNull nolog;
+    wxFFile f(fileName, "rb");
+    if (!f.IsOpened())
+        return false;
+    std::string data(f.Length(), '\0');
+    if (data.empty() || f.Read(&data[0], data.size()) != data.size())
+        return false;
+    f.Close();
+
+    size_t pos = 0;
+    std::string s;
+    if (!readCacheString(data, pos, s) || s != metadataCacheHeader)
+        return false;
+    if (!readCacheString(data, pos, s) || s != wx2std(getConnectionString()))
+        return false;
+    if (!readCacheString(data, pos, s) || s != wx2std(getConnectionCharset()))
+        return false;
+
+    size_t count;
+    if (!readCacheCount(data, pos, count) || count == 0)
+        return false;
+    std::map<std::string, std::string> cachedFingerprints;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string table, fingerprint;
+        if (!readCacheString(data, pos, table)
+            || !readCacheString(data, pos, fingerprint))
+        {
+            return false;
+        }
+        cachedFingerprints[table] = fingerprint;
+    }
+
+    std::map<std::string, std::vector<std::string> > identifiers;
+    if (!readCacheCount(data, pos, count))
+        return false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string sql;
+        size_t nameCount;
+        if (!readCacheString(data, pos, sql)
+            || !readCacheCount(data, pos, nameCount))
+        {
+            return false;
+        }
+        std::vector<std::string>& names = identifiers[sql];
+        names.resize(nameCount);
+        for (size_t j = 0; j < nameCount; ++j)
+        {
+            if (!readCacheString(data, pos, names[j]))
+                return false;
+        }
+    }
+
+    std::map<std::string, MetadataRows::RowList> rows;
+    if (!readCacheCount(data, pos, count))
+        return false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string sql;
+        size_t rowCount;
+        if (!readCacheString(data, pos, sql)
+            || !readCacheCount(data, pos, rowCount))
+        {
+            return false;
+        }
+        MetadataRows::RowList& list = rows[sql];
+        list.resize(rowCount);
+        for (size_t j = 0; j < rowCount; ++j)
+        {
+            size_t valueCount;
+            if (!readCacheCount(data, pos, valueCount))
+                return false;
+            list[j].resize(valueCount);
+            for (size_t k = 0; k < valueCount; ++k)
+            {
+                if (!readCacheValue(data, pos, list[j][k]))
+                    return false;
+            }
+        }
+    }
+
+    fingerprints.swap(cachedFingerprints);
+    loadedIdentifiersM.swap(identifiers);
+    loadedRowsM.swap(rows);
+    return true;
+}
+
+// removes the item names and rows read from system tables that have been
+// changed since the metadata cache was written, so they are loaded again
+void Database::dropChangedMetadata(
+    const std::map<std::string, std::string>& cachedFingerprints,
+    const std::map<std::string, std::string>& fingerprints)
+{
+    std::set<std::string> changedTables;
+    for (std::map<std::string, std::string>::const_iterator it =
+        fingerprints.begin(); it != fingerprints.end(); ++it)
+    {
+        std::map<std::string, std::string>::const_iterator cached =
+            cachedFingerprints.find(it->first);
+        if (cached == cachedFingerprints.end()
+            || cached->second != it->second)
+        {
+            changedTables.insert(it->first);
+        }
+    }
+
+    for (std::map<std::string, std::vector<std::string> >::iterator it =
+        loadedIdentifiersM.begin(); it != loadedIdentifiersM.end(); )
+    {
+        if (statementUnchanged(it->first, fingerprints, changedTables))
+            ++it;
+        else
+            it = loadedIdentifiersM.erase(it);
+    }
+    for (std::map<std::string, MetadataRows::RowList>::iterator it =
+        loadedRowsM.begin(); it != loadedRowsM.end(); )
+    {
+        if (statementUnchanged(it->first, fingerprints, changedTables))
+            ++it;
+        else
+            it = loadedRowsM.erase(it);
+    }
+}
+
+void Database::writeMetadataCache(
+    const std::map<std::string, std::string>& fingerprints)
+{
+    std::string data;
+    appendCacheString(data, metadataCacheHeader);
+    appendCacheString(data, wx2std(getConnectionString()));
+    appendCacheString(data, wx2std(getConnectionCharset()));
+
+    appendCacheString(data, std::to_string(fingerprints.size()));
+    for (std::map<std::string, std::string>::const_iterator it =
+        fingerprints.begin(); it != fingerprints.end(); ++it)
+    {
+        appendCacheString(data, it->first);
+        appendCacheString(data, it->second);
+    }
+
+    appendCacheString(data, std::to_string(loadedIdentifiersM.size()));
+    for (std::map<std::string, std::vector<std::string> >::const_iterator it =
+        loadedIdentifiersM.begin(); it != loadedIdentifiersM.end(); ++it)
+    {
+        appendCacheString(data, it->first);
+        appendCacheString(data, std::to_string(it->second.size()));
+        for (size_t i = 0; i < it->second.size(); ++i)
+            appendCacheString(data, it->second[i]);
+    }
+
+    appendCacheString(data, std::to_string(loadedRowsM.size()));
+    for (std::map<std::string, MetadataRows::RowList>::const_iterator it =
+        loadedRowsM.begin(); it != loadedRowsM.end(); ++it)
+    {
+        appendCacheString(data, it->first);
+        appendCacheString(data, std::to_string(it->second.size()));
+        for (const MetadataRows::Row& row : it->second)
+        {
+            appendCacheString(data, std::to_string(row.size()));
+            for (const MetadataRows::Value& value : row)
+                appendCacheValue(data, value);
+        }
+    }
+
+    // the cache is only an optimization, failing to write it is no error
+    wxLogNull nolog;
+    wxString fileName(getMetadataCacheFileName());
+    wxString tempFileName(fileName + ".tmp");
+    wxFFile f(tempFileName, "wb");
+    if (!f.IsOpened())
+        return;
+    bool written = f.Write(data.data(), data.size()) == data.size();
+    if (f.Close() && written)
+        wxRenameFile(tempFileName, fileName, true);
+    else
+        wxRemoveFile(tempFileName);
+}
+
+// reads the fingerprints over another attachment, and lets the main thread
+// reload the metadata of system tables changed since the cache was written
+void Database::startMetadataCacheValidation(
+    const std::map<std::string, std::string>& cachedFingerprints)
+{
+    stopMetadataCacheValidation();
+    if (!wxTheApp)
+        return;
+
+    // the attachment is created here, as the worker thread must not
+    // access this object
+    IBPP::Database attachment(createIBPPDatabase(databaseM->UserPassword()));
+    std::string sql(getMetadataFingerprintsStatement());
+    std::weak_ptr<Database> database(shared_from_this());
+    unsigned validationId = metadataCacheValidationIdM;
+
+    metadataCacheValidationM = std::thread([=]() mutable
+    {
+        std::map<std::string, std::string> fingerprints;
+        try
+        {
+            attachment->Connect();
+            {
+                MetadataLoader loader(attachment);
+                fingerprints = readMetadataFingerprints(loader, sql);
+            }
+            attachment->Disconnect();
+        }
+        catch (...)
+        {
+            // the cached metadata stays in use, it is checked again
+            // on the next connect
+            return;
+        }
+
+        if (wxTheApp)
+        {
+            wxTheApp->CallAfter(
+                [database, validationId, cachedFingerprints, fingerprints]()
+            {
+                DatabasePtr db(database.lock());
+                if (db && db->metadataCacheValidationIdM == validationId)
+                    db->reloadChangedMetadata(cachedFingerprints, fingerprints);
+            });
+        }
+    });
+}
+
+void Database::stopMetadataCacheValidation()
+{
+    // a reload queued by a running validation is ignored
+    ++metadataCacheValidationIdM;
+    if (metadataCacheValidationM.joinable())
+        metadataCacheValidationM.join();
+}
+
+void Database::reloadChangedMetadata(
+    const std::map<std::string, std::string>& cachedFingerprints,
+    const std::map<std::string, std::string>& fingerprints)
+{
+    // metadata being loaded (while events are processed by a progress
+    // dialog) is not interrupted, the cache is checked again on the next
+    // connect
+    if (!connectedM || collectMetadataM || fingerprints.empty()
+        || fingerprints == cachedFingerprints)
+    {
+        return;
+    }
+
+    try
+    {
+        loadMetadata(0, fingerprints);
+    }
+    catch (std::exception&)
+    {
+        // the cache is only an optimization, so make sure the next connect
+        // loads everything from the database instead of reporting an error
+        // for something the user didn't do
+        wxLogNull nolog;
+        wxRemoveFile(getMetadataCacheFileName());
+    }
+    notifyObservers();
+}
+
 void Database::disconnect()
 {
     if (connectedM)
@@ -1439,8 +2349,15 @@ void Database::disconnect()
 
 void Database::setDisconnected()
 {
+    // a new logging attachment is created with the credentials of the
+    // next connection
+    Logger::releaseDatabase(this);
+    stopMetadataCacheValidation();
     delete metadataLoaderM;
     metadataLoaderM = 0;
+    loadedIdentifiersM.clear();
+    loadedRowsM.clear();
+    relationNamesM.clear();
     resetCredentials();     // "forget" temporary username/password
     connectedM = false;
     resetPendingLoadData();
@@ -1895,6 +2812,12 @@ IBPP::Database& Database::getIBPPDatabase()
     return databaseM;
 }
 
+IBPP::Database Database::createAttachment()
+{
+    wxString password(databaseM->UserPassword());
+    return createIBPPDatabase(password);
+}
+
 void Database::setIsVolatile(const bool isVolatile)
 {
     volatileM = isVolatile;
@@ -2057,6 +2980,162 @@ void Database::loadInfo()
     notifyObservers();
 }
 
+namespace
+{
+    template <class T>
+    void addRelations(T& collection, std::map<wxString, Relation*>& relations)
+    {
+        for (typename T::iterator it = collection.begin();
+            it != collection.end(); ++it)
+        {
+            relations[(*it)->getName_()] = (*it).get();
+        }
+    }
+
+    // skips all rows of a relation that isn't loaded, returns false if no
+    // rows are left
+    bool skipRelationRows(MetadataRows& rows, const wxString& name,
+        wxMBConv* conv)
+    {
+        bool more;
+        do
+            more = rows.fetch();
+        while (more && Relation::getRelationName(rows, conv) == name);
+        return more;
+    }
+}
+
+// returns the rows of a statement loading the details of all relations,
+// from the metadata cache if they are there
+MetadataRows Database::loadMetadataRows(const std::string& sql)
+{
+    std::map<std::string, MetadataRows::RowList>::iterator it =
+        loadedRowsM.find(sql);
+    if (it != loadedRowsM.end())
+        return MetadataRows(it->second);
+
+    IBPP::Statement& st1 = getMetadataLoader()->getStatement(sql);
+    st1->Execute();
+    if (!collectMetadataM)
+        return MetadataRows(st1);
+
+    uncachedMetadataLoadedM = true;
+    MetadataRows::RowList& rows = loadedRowsM[sql];
+    rows.clear();
+    return MetadataRows(st1, &rows);
+}
+
+// loads the columns of all relations and the constraints and indices of
+// all tables with one statement each, instead of several statements per
+// relation when they are first needed, and the descriptions of all
+// relations and their columns
+void Database::loadRelationDetails(ProgressIndicator* progressIndicator)
+{
+    static const Table::DetailsType detailsTypes[] = {
+        Table::dtPrimaryKey, Table::dtUniqueConstraints,
+        Table::dtForeignKeys, Table::dtCheckConstraints, Table::dtIndices };
+    const int detailsCount = sizeof(detailsTypes) / sizeof(detailsTypes[0]);
+    const wxString detailsNames[detailsCount] = {
+        _("primary keys"), _("unique constraints"), _("foreign keys"),
+        _("check constraints"), _("indices") };
+
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    SubjectLocker lock(this);
+    wxMBConv* conv = getCharsetConverter();
+
+    std::map<wxString, Relation*> relations;
+    addRelations(*tablesM, relations);
+    addRelations(*sysTablesM, relations);
+    addRelations(*GTTablesM, relations);
+    addRelations(*viewsM, relations);
+
+    if (progressIndicator)
+    {
+        progressIndicator->initProgress(_("Loading columns..."),
+            detailsCount + 2, 0, 1);
+    }
+    MetadataRows rows1(loadMetadataRows(
+        Relation::getColumnsStatement(this, true)));
+    bool more = rows1.fetch();
+    while (more)
+    {
+        wxString name(Relation::getRelationName(rows1, conv));
+        std::map<wxString, Relation*>::iterator it = relations.find(name);
+        if (it != relations.end())
+            more = it->second->readColumns(rows1);
+        else
+            more = skipRelationRows(rows1, name, conv);
+    }
+
+    checkProgressIndicatorCanceled(progressIndicator);
+    if (progressIndicator)
+    {
+        progressIndicator->initProgress(_("Loading descriptions..."),
+            detailsCount + 2, 1, 1);
+    }
+    // relations without a row have no description, the descriptions of
+    // the columns have been read with them
+    for (std::map<wxString, Relation*>::iterator it = relations.begin();
+        it != relations.end(); ++it)
+    {
+        it->second->setLoadedDescription(wxEmptyString);
+    }
+    MetadataRows rows2(loadMetadataRows(
+        "select rdb$description, rdb$relation_name from rdb$relations "
+        "where rdb$description is not null"));
+    while (rows2.fetch())
+    {
+        std::map<wxString, Relation*>::iterator it = relations.find(
+            Relation::getRelationName(rows2, conv));
+        if (it != relations.end())
+        {
+            wxString description;
+            readBlob(rows2, 1, description, conv);
+            it->second->setLoadedDescription(description);
+        }
+    }
+
+    std::map<wxString, Table*> tables;
+    for (std::map<wxString, Relation*>::iterator it = relations.begin();
+        it != relations.end(); ++it)
+    {
+        if (Table* t = dynamic_cast<Table*>(it->second))
+            tables[it->first] = t;
+    }
+
+    for (int i = 0; i < detailsCount; ++i)
+    {
+        checkProgressIndicatorCanceled(progressIndicator);
+        if (progressIndicator)
+        {
+            progressIndicator->initProgress(wxString::Format(
+                _("Loading %s..."), detailsNames[i].c_str()),
+                detailsCount + 2, i + 2, 1);
+        }
+
+        // tables without any rows in the result set have none of them
+        for (std::map<wxString, Table*>::iterator it = tables.begin();
+            it != tables.end(); ++it)
+        {
+            it->second->clearDetails(detailsTypes[i]);
+        }
+
+        MetadataRows rows3(loadMetadataRows(
+            Table::getDetailsStatement(detailsTypes[i], true)));
+        more = rows3.fetch();
+        while (more)
+        {
+            wxString name(Relation::getRelationName(rows3, conv));
+            std::map<wxString, Table*>::iterator it = tables.find(name);
+            if (it != tables.end())
+                more = it->second->readDetails(detailsTypes[i], rows3);
+            else
+                more = skipRelationRows(rows3, name, conv);
+        }
+    }
+}
+
 bool Database::showSystemCharacterSet()
 {
     const wxString SHOW_SYSCHARACTERSET = "ShowSystemCharacterSet";
@@ -2140,6 +3219,39 @@ bool Database::showOneNodeIndices()
     return b;
 }
 
+bool Database::prefetchRelationDetails()
+{
+    const wxString PREFETCH_RELATIONDETAILS = "PrefetchRelationDetails";
+
+    bool b;
+    if (!DatabaseConfig(this, config()).getValue(PREFETCH_RELATIONDETAILS, b))
+        b = config().get(PREFETCH_RELATIONDETAILS, false);
+
+    return b;
+}
+
+bool Database::useMetadataCache()
+{
+    const wxString USE_METADATA_CACHE = "UseMetadataCache";
+
+    bool b;
+    if (!DatabaseConfig(this, config()).getValue(USE_METADATA_CACHE, b))
+        b = config().get(USE_METADATA_CACHE, false);
+
+    return b;
+}
+
+bool Database::loadCollectionsConcurrently()
+{
+    const wxString LOAD_COLLECTIONS_CONCURRENTLY = "LoadCollectionsConcurrently";
+
+    bool b;
+    if (!DatabaseConfig(this, config()).getValue(LOAD_COLLECTIONS_CONCURRENTLY, b))
+        b = config().get(LOAD_COLLECTIONS_CONCURRENTLY, false);
+
+    return b;
+}
+
 wxString mapConnectionCharsetToSystemCharset(const wxString& connectionCharset)
 {
     wxString charset(connectionCharset.Upper().Trim(true).Trim(false));
@@ -2289,6 +3401,25 @@ void Database::loadTimezones()
         tzItm->name = std2wxIdentifier(tzName, converter);
         timezonesM.push_back(tzItm);
     }
+
+    // the ids are a dense range at the top of the 16 bit range
+    timezoneNamesM.clear();
+    if (timezonesM.empty())
+        return;
+    int minId = timezonesM.front()->id, maxId = minId;
+    for (std::vector<TimezoneInfo*>::iterator it = timezonesM.begin();
+        it != timezonesM.end(); it++)
+    {
+        minId = std::min(minId, int((*it)->id));
+        maxId = std::max(maxId, int((*it)->id));
+    }
+    timezoneIdOffsetM = minId;
+    timezoneNamesM.resize(maxId - minId + 1);
+    for (std::vector<TimezoneInfo*>::iterator it = timezonesM.begin();
+        it != timezonesM.end(); it++)
+    {
+        timezoneNamesM[(*it)->id - minId] = (*it)->name;
+    }
 }
 
 TimezoneInfo Database::getDefaultTimezone()
@@ -2299,13 +3430,9 @@ TimezoneInfo Database::getDefaultTimezone()
 
 wxString Database::getTimezoneName(int timezone)
 {
-    std::vector<TimezoneInfo*>::iterator it;
-    for (it = timezonesM.begin(); it != timezonesM.end(); it++)
-    {
-        if ((*it)->id != timezone)
-            continue;
-        return (*it)->name;
-    }
+    size_t index = size_t(timezone - timezoneIdOffsetM);
+    if (index < timezoneNamesM.size() && !timezoneNamesM[index].empty())
+        return timezoneNamesM[index];
     // not found
     return wxString::Format("TZ %d", timezone);
 }
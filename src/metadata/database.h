@@ -27,13 +27,17 @@
 #include <wx/strconv.h>
 
 #include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <ibpp.h>
 
+#include "engine/MetadataLoader.h"
 #include "metadata/MetadataClasses.h"
 #include "metadata/metadataitem.h"
 
-class MetadataLoader;
 class ProgressIndicator;
 class SqlStatement;
 
@@ -179,6 +183,9 @@ private:
     Credentials* connectionCredentialsM;
     DatabaseAuthenticationMode authenticationModeM;
     std::vector<TimezoneInfo*> timezonesM;
+    // timezone names indexed by id - timezoneIdOffsetM
+    std::vector<wxString> timezoneNamesM;
+    int timezoneIdOffsetM;
     TimezoneInfo defaultTimezoneM;
 
     std::unique_ptr<wxMBConv> charsetConverterM;
@@ -220,15 +227,62 @@ private:
     //std::multimap<CharacterSet, wxString> collationsM;
     void loadCollations();
 
+    void loadMetadata(ProgressIndicator* progressIndicator,
+        std::map<std::string, std::string> fingerprints);
     void loadCollections(ProgressIndicator* progressIndicator);
 
+    // item names for the load statements of the collections, read from the
+    // metadata cache or by prefetchIdentifiers(), and (while collecting)
+    // by loadIdentifiers() itself, which hands them out instead of querying
+    std::map<std::string, std::vector<std::string> > loadedIdentifiersM;
+    // the same for the rows of the statements loading relation details
+    std::map<std::string, MetadataRows::RowList> loadedRowsM;
+    bool collectMetadataM;
+    // set when metadata missing from the cache has been read while collecting
+    bool uncachedMetadataLoadedM;
+    void prefetchIdentifiers(const std::vector<std::string>& statements,
+        ProgressIndicator* progressIndicator);
+    MetadataRows loadMetadataRows(const std::string& sql);
+    IBPP::Database createIBPPDatabase(const wxString& password);
+
+    // the metadata cache keeps the item names of all collections and the
+    // details of all relations in a file per database, together with
+    // fingerprints of the system tables they were read from; after they
+    // have been loaded from the cache a worker thread checks the
+    // fingerprints, and metadata of changed tables is reloaded afterwards
+    wxString getMetadataCacheFileName();
+    std::string getMetadataFingerprintsStatement();
+    std::map<std::string, std::string> loadMetadataFingerprints();
+    bool readMetadataCache(std::map<std::string, std::string>& fingerprints);
+    void dropChangedMetadata(
+        const std::map<std::string, std::string>& cachedFingerprints,
+        const std::map<std::string, std::string>& fingerprints);
+    void writeMetadataCache(
+        const std::map<std::string, std::string>& fingerprints);
+    std::thread metadataCacheValidationM;
+    unsigned metadataCacheValidationIdM;
+    void startMetadataCacheValidation(
+        const std::map<std::string, std::string>& cachedFingerprints);
+    void stopMetadataCacheValidation();
+    void reloadChangedMetadata(
+        const std::map<std::string, std::string>& cachedFingerprints,
+        const std::map<std::string, std::string>& fingerprints);
+
     void loadDatabaseInfo();
 
     void loadDefaultTimezone();
     void loadTimezones();
 
     // small help for parser
-    wxString getTableForIndex(const wxString& indexName);
+    std::map<wxString, wxString> getTablesForIndices(
+        const std::set<wxString>& indexNames);
+
+    struct CommitedDDL;
+    void parseCommitedSql(const SqlStatement& stm, CommitedDDL& ddl);
+    void applyCommitedDDL(CommitedDDL& ddl);
+
+    // names of all relations by id, cleared after DDL statements
+    std::map<int, wxString> relationNamesM;
 
     mutable unsigned idM;
 
@@ -239,6 +293,9 @@ private:
     bool showSystemRoles();
     bool showSystemTables();
     bool showOneNodeIndices();
+    bool prefetchRelationDetails();
+    bool loadCollectionsConcurrently();
+    bool useMetadataCache();
 
     inline void checkConnected(const wxString& operation) const;
 protected:
@@ -252,6 +309,7 @@ public:
 
     virtual bool getChildren(std::vector<MetadataItem *>& temp);
     void getCollections(std::vector<MetadataItem *>& temp, bool system);
+    void loadRelationDetails(ProgressIndicator* progressIndicator = 0);
 
     CharacterSetsPtr getCharacterSets();
     CollationsPtr getCollations();
@@ -289,11 +347,15 @@ public:
 
     MetadataLoader* getMetadataLoader();
 
+    // returns the name of the relation with the given id, or an empty
+    // string if there is none
+    wxString getRelationName(int relationId);
+
     wxArrayString loadIdentifiers(const wxString& loadStatement,
         ProgressIndicator* progressIndicator = 0);
 
-    wxString loadDomainNameForColumn(const wxString& table,
-        const wxString& field);
+    std::vector<wxString> loadDomainNamesForColumns(
+        const std::vector<std::pair<wxString, wxString> >& columns);
     DomainPtr getDomain(const wxString& name);
 
     void loadGeneratorValues();
@@ -308,6 +370,9 @@ public:
     void dropObject(MetadataItem *object);
     void addObject(NodeType type, const wxString& name);
     void parseCommitedSql(const SqlStatement& stm);     // reads a DDL statement and does accordingly
+    // reads all DDL statements of a commit, objects are reloaded and
+    // observers notified once after all statements are processed
+    void parseCommitedSql(const std::vector<SqlStatement>& statements);
 
     CharacterSetPtr getCharsetById(int id);
     wxArrayString getCharacterSet();
@@ -337,6 +402,9 @@ public:
     DatabaseAuthenticationMode& getAuthenticationMode();
     wxString getRole() const;
     IBPP::Database& getIBPPDatabase();
+    // returns a new attachment (not yet connected) using the credentials
+    // of the current connection, for work done on other threads
+    IBPP::Database createAttachment();
     void setIsVolatile(const bool isVolatile);
     void setPath(const wxString& value);
     void setClientLibrary(const wxString& value);
@@ -507,10 +507,16 @@ void Domains::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Domains::load(ProgressIndicator* progressIndicator)
 {
-    wxString stmt = "select rdb$field_name from rdb$fields "
+    loadItems(progressIndicator);
+}
+
+wxArrayString Domains::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select rdb$field_name from rdb$fields "
         " where rdb$system_flag = 0 and rdb$field_name not starting 'RDB$' "
-        " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        " order by 1");
+    return statements;
 }
 
 void Domains::loadChildren()
@@ -536,10 +542,16 @@ void SysDomains::acceptVisitor(MetadataItemVisitor* visitor)
 
 void SysDomains::load(ProgressIndicator* progressIndicator)
 {
-    wxString stmt = "select rdb$field_name from rdb$fields "
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysDomains::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select rdb$field_name from rdb$fields "
         " where rdb$system_flag = 1 "
-        " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        " order by 1");
+    return statements;
 }
 
 const wxString SysDomains::getTypeName() const
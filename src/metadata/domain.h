@@ -87,6 +87,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -97,6 +98,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -680,6 +680,12 @@ void FunctionSQLs::acceptVisitor(MetadataItemVisitor* visitor)
 
 void FunctionSQLs::load(ProgressIndicator* progressIndicator)
 {
+	loadItems(progressIndicator);
+}
+
+wxArrayString FunctionSQLs::getLoadStatements() const
+{
+	wxArrayString statements;
 	DatabasePtr db = getDatabase();
 	if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
 	{
@@ -687,8 +693,9 @@ void FunctionSQLs::load(ProgressIndicator* progressIndicator)
 		" where (rdb$system_flag = 0 or rdb$system_flag is null)";
 		stmt += " and RDB$LEGACY_FLAG = 0  and rdb$package_name is null ";
 		stmt += " order by 1";
-		setItems(db->loadIdentifiers(stmt, progressIndicator));
+		statements.push_back(stmt);
 	}
+	return statements;
 }
 
 void FunctionSQLs::loadChildren()
@@ -901,6 +908,11 @@ void UDFs::acceptVisitor(MetadataItemVisitor* visitor)
 }
 
 void UDFs::load(ProgressIndicator* progressIndicator)
+{
+	loadItems(progressIndicator);
+}
+
+wxArrayString UDFs::getLoadStatements() const
 {
 	DatabasePtr db = getDatabase();
 	wxString stmt = "select rdb$function_name from rdb$functions "
@@ -908,7 +920,9 @@ void UDFs::load(ProgressIndicator* progressIndicator)
 	if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
 		stmt += " and RDB$LEGACY_FLAG = 1 and rdb$package_name is null ";
 	stmt += " order by 1";
-	setItems(db->loadIdentifiers(stmt, progressIndicator));
+	wxArrayString statements;
+	statements.push_back(stmt);
+	return statements;
 }
 
 void UDFs::loadChildren()
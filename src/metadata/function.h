@@ -118,6 +118,7 @@ public:
 
 	virtual void acceptVisitor(MetadataItemVisitor* visitor);
 	void load(ProgressIndicator* progressIndicator);
+	virtual wxArrayString getLoadStatements() const;
 	virtual const wxString getTypeName() const;
 
 };
@@ -131,6 +132,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -31,6 +31,8 @@
 #endif
 
 
+#include <map>
+
 #include <ibpp.h>
 
 #include "core/FRError.h"
@@ -92,6 +94,16 @@ void Generator::loadProperties()
     notifyObservers();
 }
 
+void Generator::setValues(int64_t value, int64_t initialValue,
+    int64_t incrementalValue)
+{
+    valueM = value;
+    initialValueM = initialValue;
+    incrementalValueM = incrementalValue;
+    setPropertiesLoaded(true);
+    notifyObservers();
+}
+
 const wxString Generator::getTypeName() const
 {
     return "GENERATOR";
@@ -184,10 +196,16 @@ void Generators::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Generators::load(ProgressIndicator* progressIndicator)
 {
-    wxString stmt = "select rdb$generator_name from rdb$generators"
+    loadItems(progressIndicator);
+}
+
+wxArrayString Generators::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select rdb$generator_name from rdb$generators"
         " where (rdb$system_flag = 0 or rdb$system_flag is null)"
-        " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        " order by 1");
+    return statements;
 }
 
 void Generators::loadChildren()
@@ -200,3 +218,80 @@ const wxString Generators::getTypeName() const
     return "GENERATOR_COLLECTION";
 }
 
+void Generators::loadValues()
+{
+    if (empty())
+        return;
+
+    DatabasePtr db = getDatabase();
+    MetadataLoader* loader = db->getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    wxMBConv* converter = db->getCharsetConverter();
+
+    // initial values and increments of all generators at once
+    typedef std::pair<int64_t, int64_t> Settings;
+    std::map<wxString, Settings> settings;
+    if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+    {
+        IBPP::Statement& st1 = loader->getStatement(
+            "select RDB$GENERATOR_NAME, RDB$INITIAL_VALUE, "
+            "RDB$GENERATOR_INCREMENT from RDB$GENERATORS "
+            "where (RDB$SYSTEM_FLAG = 0 or RDB$SYSTEM_FLAG is null)");
+        st1->Execute();
+        while (st1->Fetch())
+        {
+            std::string name;
+            Settings values(0, 0);
+            st1->Get(1, name);
+            if (!st1->IsNull(2))
+                st1->Get(2, values.first);
+            if (!st1->IsNull(3))
+                st1->Get(3, values.second);
+            settings[std2wxIdentifier(name, converter)] = values;
+        }
+    }
+
+    // the current values are read with a multi-column select from
+    // rdb$database, split into several statements to keep the number of
+    // columns and the statement length well below the server limits
+    const size_t maxColumns = 255;
+    const size_t maxStatementLength = 32000;
+    std::vector<Generator*> generators;
+    std::string sql;
+    for (iterator it = begin(); it != end(); )
+    {
+        Generator* generator = (*it).get();
+        ++it;
+        // IMPORTANT: for all other loading where the name of the db object is
+        // Set() into a parameter getName_() is used, but for dynamically
+        // building the SQL statement getQuotedName() must be used!
+        sql += (generators.empty() ? "select gen_id(" : ", gen_id(")
+            + wx2std(generator->getQuotedName(), converter) + ", 0)";
+        generators.push_back(generator);
+
+        if (it != end() && generators.size() < maxColumns
+            && sql.size() < maxStatementLength)
+        {
+            continue;
+        }
+        // do not use cached statements, because these can not be reused
+        IBPP::Statement st1 = loader->createStatement(
+            sql + " from rdb$database");
+        st1->Execute();
+        st1->Fetch();
+        for (size_t i = 0; i < generators.size(); ++i)
+        {
+            int64_t value;
+            st1->Get(int(i + 1), value);
+            Settings values(0, 0);
+            std::map<wxString, Settings>::iterator pos =
+                settings.find(generators[i]->getName_());
+            if (pos != settings.end())
+                values = pos->second;
+            generators[i]->setValues(value, values.first, values.second);
+        }
+        generators.clear();
+        sql.clear();
+    }
+}
+
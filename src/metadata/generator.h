@@ -33,11 +33,14 @@ class ProgressIndicator;
 class Generator: public MetadataItem
 {
 private:
+    friend class Generators;
+
     int64_t valueM;
     int64_t initialValueM;
     int64_t incrementalValueM;
     std::vector<Privilege> privilegesM;
-    void setValue(int64_t value);
+    void setValues(int64_t value, int64_t initialValue,
+        int64_t incrementalValue);
 protected:
     virtual void loadProperties();
 public:
@@ -60,7 +63,10 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
+    // reads the values of all generators with as few statements as possible
+    void loadValues();
 };
 
 #endif
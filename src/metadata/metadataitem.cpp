@@ -687,10 +687,15 @@ void MetadataItem::setDescription(const wxString& description)
     }
 }
 
-void MetadataItem::setDescriptionIsEmpty()
+void MetadataItem::setLoadedDescription(const wxString& description)
 {
     descriptionLoadedM = lsLoaded;
-    descriptionM = wxEmptyString;
+    descriptionM = description;
+}
+
+void MetadataItem::setDescriptionIsEmpty()
+{
+    setLoadedDescription(wxEmptyString);
 }
 
 MetadataItem* MetadataItem::getParent() const
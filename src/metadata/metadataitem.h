@@ -140,6 +140,9 @@ public:
     bool getDescription(wxString& description);
     void invalidateDescription();
     void setDescription(const wxString& description);
+    // sets the description read together with other metadata, without
+    // saving it or notifying observers
+    void setLoadedDescription(const wxString& description);
 
     bool childrenLoaded() const;
     void ensureChildrenLoaded();
@@ -492,11 +492,19 @@ void Packages::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Packages::load(ProgressIndicator* progressIndicator)
 {
-	DatabasePtr db = getDatabase();
-    wxString stmt = "select rdb$package_name from rdb$packages ";
-    stmt += " where rdb$system_flag = 0 ";
-	stmt += " order by rdb$package_name ";
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
+    loadItems(progressIndicator);
+}
+
+wxArrayString Packages::getLoadStatements() const
+{
+    wxArrayString statements;
+    if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+    {
+        statements.push_back("select rdb$package_name from rdb$packages "
+            " where rdb$system_flag = 0 "
+            " order by rdb$package_name ");
+    }
+    return statements;
 }
 
 void Packages::loadChildren()
@@ -554,11 +562,19 @@ void SysPackages::acceptVisitor(MetadataItemVisitor* visitor)
 
 void SysPackages::load(ProgressIndicator* progressIndicator)
 {
-    DatabasePtr db = getDatabase();
-    wxString stmt = "select rdb$package_name from rdb$packages ";
-    stmt += " where rdb$system_flag = 1 ";
-    stmt += " order by rdb$package_name ";
-    setItems(db->loadIdentifiers(stmt, progressIndicator));
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysPackages::getLoadStatements() const
+{
+    wxArrayString statements;
+    if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+    {
+        statements.push_back("select rdb$package_name from rdb$packages "
+            " where rdb$system_flag = 1 "
+            " order by rdb$package_name ");
+    }
+    return statements;
 }
 
 const wxString SysPackages::getTypeName() const
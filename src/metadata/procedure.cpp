@@ -589,12 +589,19 @@ void Procedures::acceptVisitor(MetadataItemVisitor* visitor)
 }
 
 void Procedures::load(ProgressIndicator* progressIndicator)
+{
+    loadItems(progressIndicator);
+}
+
+wxArrayString Procedures::getLoadStatements() const
 {
     wxString stmt = "select rdb$procedure_name from rdb$procedures"
         " where (rdb$system_flag = 0 or rdb$system_flag is null)";
     stmt += getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0) ? " and rdb$package_name is null " : " ";
     stmt += " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    wxArrayString statements;
+    statements.push_back(stmt);
+    return statements;
 }
 
 void Procedures::loadChildren()
@@ -211,11 +211,29 @@ void Relation::loadChildren()
     MetadataLoaderTransaction tr(loader);
     SubjectLocker lock(db.get());
     wxMBConv* converter = db->getCharsetConverter();
+
+    IBPP::Statement& st1 = loader->getStatement(
+        getColumnsStatement(db.get(), false));
+    st1->Set(1, wx2std(getName_(), converter));
+    st1->Execute();
+    MetadataRows rows(st1);
+    if (rows.fetch())
+        readColumns(rows);
+    else
+    {
+        ColumnPtrs columns;
+        setColumns(columns);
+    }
+}
+
+std::string Relation::getColumnsStatement(Database* db, bool allRelations)
+{
     std::string sql(
             "select r.rdb$field_name, r.rdb$null_flag, r.rdb$field_source,"         //1,2,3
             " l.rdb$collation_name, f.rdb$computed_source, r.rdb$default_source,"   //4,5,6
             " r.rdb$description ");                                                 //7
     sql += db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0) ? ", r.RDB$GENERATOR_NAME, r.RDB$IDENTITY_TYPE, g.RDB$INITIAL_VALUE, RDB$GENERATOR_INCREMENT " : ", null, null, null, null "; //8,9, 10, 11
+    sql +=  ", r.rdb$relation_name";                                               //12
     sql +=  " from rdb$fields f"
             " join rdb$relation_fields r "
             "     on f.rdb$field_name=r.rdb$field_source"
@@ -225,47 +243,54 @@ void Relation::loadChildren()
     
     if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
         sql += " left join RDB$GENERATORS g on g.RDB$GENERATOR_NAME = r.RDB$GENERATOR_NAME ";
-    sql +=  " where r.rdb$relation_name = ?"
-            " order by r.rdb$field_position";
-    
-    IBPP::Statement& st1 = loader->getStatement(sql);
-    st1->Set(1, wx2std(getName_(), converter));
-    st1->Execute();
+    if (allRelations)
+        sql += " order by r.rdb$relation_name, r.rdb$field_position";
+    else
+    {
+        sql += " where r.rdb$relation_name = ?"
+               " order by r.rdb$field_position";
+    }
+    return sql;
+}
 
+wxString Relation::getRelationName(const MetadataRows& rows,
+    wxMBConv* converter)
+{
+    return std2wxIdentifier(rows.getString(rows.columns()), converter);
+}
+
+bool Relation::readColumns(MetadataRows& rows)
+{
+    wxMBConv* converter = getDatabase()->getCharsetConverter();
     ColumnPtrs columns;
-    while (st1->Fetch())
+    bool more;
+    do
     {
-        std::string s, coll;
-        st1->Get(1, s);
-        wxString fname(std2wxIdentifier(s, converter));
-        bool notNull = false;
-        if (!st1->IsNull(2))
-            st1->Get(2, &notNull);
-        st1->Get(3, s);
-        wxString source(std2wxIdentifier(s, converter));
-        if (!st1->IsNull(4))
-            st1->Get(4, coll);
-        wxString collation(std2wxIdentifier(coll, converter));
+        wxString fname(std2wxIdentifier(rows.getString(1), converter));
+        bool notNull = !rows.isNull(2) && rows.getInt(2) != 0;
+        wxString source(std2wxIdentifier(rows.getString(3), converter));
+        wxString collation(std2wxIdentifier(rows.getString(4), converter));
         wxString computedSrc, defaultSrc;
-        readBlob(st1, 5, computedSrc, converter);
-        bool hasDefault = !st1->IsNull(6);
+        readBlob(rows, 5, computedSrc, converter);
+        bool hasDefault = !rows.isNull(6);
         if (hasDefault)
         {
-            readBlob(st1, 6, defaultSrc, converter);
+            readBlob(rows, 6, defaultSrc, converter);
             // Some users reported two spaces before DEFAULT word in source
             // Perhaps some other tools can put garbage here? Should we
             // parse it as SQL to clean up comments, whitespace, etc?
             defaultSrc.Trim(false).Remove(0, 8);
         }
-        bool hasDescription = !st1->IsNull(7);
+        bool hasDescription = !rows.isNull(7);
+        wxString description;
+        readBlob(rows, 7, description, converter);
         wxString identityType = "";
         int initialValue = 0, incrementValue = 0;
-        if (!st1->IsNull(8)) {
-            int i;
-            st1->Get(9, i);
+        if (!rows.isNull(8)) {
+            int i = rows.getInt(9);
             identityType = i == IDENT_TYPE_BY_DEFAULT ? "BY DEFAULT" : i == IDENT_TYPE_ALWAYS ? "ALWAYS" : "";
-            st1->Get(10, initialValue);
-            st1->Get(11, incrementValue);
+            initialValue = rows.getInt(10);
+            incrementValue = rows.getInt(11);
         }
 
 
@@ -278,8 +303,18 @@ void Relation::loadChildren()
         columns.push_back(col);
         col->initialize(source, computedSrc, collation, !notNull,
             defaultSrc, hasDefault, hasDescription, identityType, initialValue, incrementValue);
+        col->setLoadedDescription(description);
+
+        more = rows.fetch();
     }
+    while (more && getRelationName(rows, converter) == getName_());
 
+    setColumns(columns);
+    return more;
+}
+
+void Relation::setColumns(ColumnPtrs& columns)
+{
     setChildrenLoaded(true);
     if (columnsM != columns)
     {
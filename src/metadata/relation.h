@@ -25,14 +25,19 @@
 #ifndef FR_RELATION_H
 #define FR_RELATION_H
 
+#include <string>
 #include <vector>
 
+#include <ibpp.h>
+
 #include "metadata/constraints.h"
 #include "metadata/MetadataClasses.h"
 #include "metadata/metadataitem.h"
 #include "metadata/privilege.h"
 #include "metadata/trigger.h"
 
+class MetadataRows;
+
 class Relation: public MetadataItem
 {
 private:
@@ -49,6 +54,7 @@ protected:
 
     virtual void loadProperties();
     virtual void loadChildren();
+    void setColumns(ColumnPtrs& columns);
     virtual void lockChildren();
     virtual void unlockChildren();
 
@@ -88,6 +94,16 @@ public:
     bool getChildren(std::vector<MetadataItem *>& temp);
     void getTriggers(std::vector<Trigger*>& list,
         Trigger::FiringTime time);
+
+    // the statements loading relation details have the relation name in
+    // their last column, so that they can load the details of a single
+    // relation (passed as parameter) or of all relations ordered by name
+    static wxString getRelationName(const MetadataRows& rows,
+        wxMBConv* converter);
+    static std::string getColumnsStatement(Database* db, bool allRelations);
+    // reads the columns (and their descriptions) from the current row and
+    // all following rows of this relation, returns false if no rows are left
+    bool readColumns(MetadataRows& rows);
 };
 
 #endif // FR_RELATION_H
@@ -141,13 +141,19 @@ bool SysRoles::isSystem() const
 
 void SysRoles::load(ProgressIndicator* progressIndicator)
 {
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysRoles::getLoadStatements() const
+{
+    wxArrayString statements;
     DatabasePtr db = getDatabase();
     if (db && db->getInfo().getODSVersionIsHigherOrEqualTo(11, 1))
     {
-        wxString stmt = "select rdb$role_name from rdb$roles"
-            " where (rdb$system_flag > 0) order by 1";
-        setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        statements.push_back("select rdb$role_name from rdb$roles"
+            " where (rdb$system_flag > 0) order by 1");
     }
+    return statements;
 }
 
 void SysRoles::loadChildren()
@@ -172,13 +178,20 @@ void Roles::acceptVisitor(MetadataItemVisitor* visitor)
 }
 
 void Roles::load(ProgressIndicator* progressIndicator)
+{
+    loadItems(progressIndicator);
+}
+
+wxArrayString Roles::getLoadStatements() const
 {
     wxString stmt = "select rdb$role_name from rdb$roles";
     DatabasePtr db = getDatabase();
     if (db && db->getInfo().getODSVersionIsHigherOrEqualTo(11, 1))
         stmt += " where (rdb$system_flag = 0 or rdb$system_flag is null)";
     stmt += " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    wxArrayString statements;
+    statements.push_back(stmt);
+    return statements;
 }
 
 void Roles::loadChildren()
@@ -55,6 +55,7 @@ public:
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     virtual bool isSystem() const;
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -67,6 +68,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
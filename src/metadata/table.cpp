@@ -96,163 +96,6 @@ void Table::loadChildren()
     Relation::loadChildren();
 }
 
-//! reads checks info from database
-void Table::loadCheckConstraints()
-{
-    if (checkConstraintsLoadedM)
-        return;
-    checkConstraintsM.clear();
-
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
-
-    IBPP::Statement& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, t.rdb$trigger_source, d.rdb$field_name "
-        " from rdb$relation_constraints r "
-        " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name and r.rdb$constraint_type = 'CHECK'"
-        " join rdb$triggers t on c.rdb$trigger_name=t.rdb$trigger_name and t.rdb$trigger_type = 1 "
-        " left join rdb$dependencies d on t.rdb$trigger_name = d.rdb$dependent_name "
-        "      and d.rdb$depended_on_name = r.rdb$relation_name "
-        "      and d.rdb$depended_on_type = 0 "
-        " where r.rdb$relation_name=? "
-        " order by 1 "
-    );
-
-    st1->Set(1, wx2std(getName_(), conv));
-    st1->Execute();
-    CheckConstraint *cc = 0;
-    while (st1->Fetch())
-    {
-        std::string s;
-        st1->Get(1, s);
-        wxString cname(std2wxIdentifier(s, conv));
-        if (!cc || cname != cc->getName_()) // new constraint
-        {
-            wxString source;
-            readBlob(st1, 2, source, conv);
-
-            CheckConstraint c;
-            c.setParent(this);
-            c.setName_(cname);
-            c.sourceM = source;
-            checkConstraintsM.push_back(c);
-            cc = &checkConstraintsM.back();
-        }
-
-        if (!st1->IsNull(3))
-        {
-            st1->Get(3, s);
-            wxString fname(std2wxIdentifier(s, conv));
-            cc->columnsM.push_back(fname);
-        }
-    }
-    checkConstraintsLoadedM = true;
-}
-
-//! reads primary key info from database
-void Table::loadPrimaryKey()
-{
-    if (primaryKeyLoadedM)
-        return;
-    primaryKeyM.columnsM.clear();
-
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
-
-    IBPP::Statement& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name and "
-        "(r.rdb$constraint_type='PRIMARY KEY') order by r.rdb$constraint_name, i.rdb$field_position"
-    );
-
-    st1->Set(1, wx2std(getName_(), conv));
-    st1->Execute();
-    while (st1->Fetch())
-    {
-        std::string s;
-        st1->Get(1, s);
-        wxString cname(std2wxIdentifier(s, conv));
-        st1->Get(2, s);
-        wxString fname(std2wxIdentifier(s, conv));
-        st1->Get(3, s);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        primaryKeyM.setName_(cname);
-        primaryKeyM.columnsM.push_back(fname);
-        primaryKeyM.indexNameM = ixname;
-    }
-    primaryKeyM.setParent(this);
-    primaryKeyLoadedM = true;
-}
-
-//! reads uniques from database
-void Table::loadUniqueConstraints()
-{
-    if (uniqueConstraintsLoadedM)
-        return;
-    uniqueConstraintsM.clear();
-
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
-
-    IBPP::Statement& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name and "
-        "(r.rdb$constraint_type='UNIQUE') order by r.rdb$constraint_name, i.rdb$field_position"
-    );
-
-    st1->Set(1, wx2std(getName_(), conv));
-    st1->Execute();
-    UniqueConstraint *cc = 0;
-    while (st1->Fetch())
-    {
-        std::string s;
-        st1->Get(1, s);
-        wxString cname(std2wxIdentifier(s, conv));
-        st1->Get(2, s);
-        wxString fname(std2wxIdentifier(s, conv));
-        st1->Get(3, s);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        if (cc && cc->getName_() == cname)
-            cc->columnsM.push_back(fname);
-        else
-        {
-            UniqueConstraint c;
-            uniqueConstraintsM.push_back(c);
-            cc = &uniqueConstraintsM.back();
-            cc->indexNameM = ixname;
-            cc->setName_(cname);
-            cc->columnsM.push_back(fname);
-            cc->setParent(this);
-        }
-    }
-    uniqueConstraintsLoadedM = true;
-}
-
 PrimaryKeyConstraint *Table::getPrimaryKey()
 {
     loadPrimaryKey();
@@ -285,13 +128,43 @@ std::vector<Index> *Table::getIndices()
     return &indicesM;
 }
 
+//! reads checks info from database
+void Table::loadCheckConstraints()
+{
+    if (!checkConstraintsLoadedM)
+        loadDetails(dtCheckConstraints);
+}
+
+//! reads primary key info from database
+void Table::loadPrimaryKey()
+{
+    if (!primaryKeyLoadedM)
+        loadDetails(dtPrimaryKey);
+}
+
+//! reads uniques from database
+void Table::loadUniqueConstraints()
+{
+    if (!uniqueConstraintsLoadedM)
+        loadDetails(dtUniqueConstraints);
+}
+
 //! reads foreign keys info from database
 void Table::loadForeignKeys()
 {
-    if (foreignKeysLoadedM)
-        return;
-    foreignKeysM.clear();
+    if (!foreignKeysLoadedM)
+        loadDetails(dtForeignKeys);
+}
 
+//! reads indices from database
+void Table::loadIndices()
+{
+    if (!indicesLoadedM)
+        loadDetails(dtIndices);
+}
+
+void Table::loadDetails(DetailsType type)
+{
     DatabasePtr db = getDatabase();
     wxMBConv* conv = db->getCharsetConverter();
     MetadataLoader* loader = db->getMetadataLoader();
@@ -303,152 +176,283 @@ void Table::loadForeignKeys()
     SubjectLocker lock(this);
 
     IBPP::Statement& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, c.rdb$update_rule, "
-        " c.rdb$delete_rule, c.RDB$CONST_NAME_UQ, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i, rdb$ref_constraints c "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name  "
-        "and r.rdb$constraint_name = c.rdb$constraint_name "
-        "and (r.rdb$constraint_type='FOREIGN KEY') order by 1, i.rdb$field_position"
-    );
-
-    IBPP::Statement& st2 = loader->getStatement(
-        "select r.rdb$relation_name, i.rdb$field_name"
-        " from rdb$relation_constraints r"
-        " join rdb$index_segments i on i.rdb$index_name = r.rdb$index_name "
-        " where r.rdb$constraint_name = ?"
-        " order by i.rdb$field_position "
-    );
-
+        getDetailsStatement(type, false));
     st1->Set(1, wx2std(getName_(), conv));
     st1->Execute();
-    ForeignKey *fkp = 0;
-    while (st1->Fetch())
+
+    clearDetails(type);
+    try
     {
-        std::string s;
-        st1->Get(1, s);
-        wxString cname(std2wxIdentifier(s, conv));
-        st1->Get(2, s);
-        wxString fname(std2wxIdentifier(s, conv));
-        st1->Get(3, s);
-        wxString update_rule(std2wxIdentifier(s, conv));
-        st1->Get(4, s);
-        wxString delete_rule(std2wxIdentifier(s, conv));
-        std::string ref_constraint;
-        st1->Get(5, ref_constraint);
-        st1->Get(6, s);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        if (fkp && fkp->getName_() == cname) // add column
-            fkp->columnsM.push_back(fname);
-        else
+        MetadataRows rows(st1);
+        if (rows.fetch())
+            readDetails(type, rows);
+    }
+    catch (...)
+    {
+        // in case an exception is thrown this should be repeated
+        getDetailsLoaded(type) = false;
+        throw;
+    }
+}
+
+bool& Table::getDetailsLoaded(DetailsType type)
+{
+    switch (type)
+    {
+        case dtPrimaryKey:
+            return primaryKeyLoadedM;
+        case dtUniqueConstraints:
+            return uniqueConstraintsLoadedM;
+        case dtForeignKeys:
+            return foreignKeysLoadedM;
+        case dtCheckConstraints:
+            return checkConstraintsLoadedM;
+        default:
+            return indicesLoadedM;
+    }
+}
+
+std::string Table::getDetailsStatement(DetailsType type, bool allTables)
+{
+    // restrict to the table passed as parameter, or sort by table first
+    const std::string r(allTables ? "" : "r.rdb$relation_name=? and ");
+    const std::string rOrder(allTables ? "r.rdb$relation_name, " : "");
+    switch (type)
+    {
+        case dtPrimaryKey:
+        case dtUniqueConstraints:
+            return
+                "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name, "
+                " r.rdb$relation_name "
+                "from rdb$relation_constraints r, rdb$index_segments i "
+                "where " + r + "r.rdb$index_name=i.rdb$index_name and "
+                + (type == dtPrimaryKey ? "(r.rdb$constraint_type='PRIMARY KEY') "
+                    : "(r.rdb$constraint_type='UNIQUE') ")
+                + "order by " + rOrder + "r.rdb$constraint_name, i.rdb$field_position";
+        case dtForeignKeys:
+            // the referenced columns are matched by their position in the
+            // index, so a single statement loads everything
+            return
+                "select r.rdb$constraint_name, i.rdb$field_name, c.rdb$update_rule, "
+                " c.rdb$delete_rule, c.RDB$CONST_NAME_UQ, r.rdb$index_name, "
+                " rr.rdb$relation_name, ri.rdb$field_name, r.rdb$relation_name "
+                "from rdb$relation_constraints r "
+                " join rdb$index_segments i on r.rdb$index_name=i.rdb$index_name "
+                " join rdb$ref_constraints c on r.rdb$constraint_name = c.rdb$constraint_name "
+                " left join rdb$relation_constraints rr on rr.rdb$constraint_name = c.rdb$const_name_uq "
+                " left join rdb$index_segments ri on ri.rdb$index_name = rr.rdb$index_name "
+                "   and ri.rdb$field_position = i.rdb$field_position "
+                "where " + r + "(r.rdb$constraint_type='FOREIGN KEY') "
+                "order by " + rOrder + "1, i.rdb$field_position";
+        case dtCheckConstraints:
+            return
+                "select r.rdb$constraint_name, t.rdb$trigger_source, d.rdb$field_name, "
+                " r.rdb$relation_name "
+                " from rdb$relation_constraints r "
+                " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name"
+                " join rdb$triggers t on c.rdb$trigger_name=t.rdb$trigger_name and t.rdb$trigger_type = 1 "
+                " left join rdb$dependencies d on t.rdb$trigger_name = d.rdb$dependent_name "
+                "      and d.rdb$depended_on_name = r.rdb$relation_name "
+                "      and d.rdb$depended_on_type = 0 "
+                " where " + r + "r.rdb$constraint_type = 'CHECK' "
+                " order by " + rOrder + "1 ";
+        default:
+            return
+                "SELECT i.rdb$index_name, i.rdb$unique_flag, i.rdb$index_inactive, "
+                " i.rdb$index_type, i.rdb$statistics, "
+                " s.rdb$field_name, rc.rdb$constraint_name, i.rdb$expression_source, "
+                " i.rdb$relation_name "
+                " from rdb$indices i "
+                " left join rdb$index_segments s on i.rdb$index_name = s.rdb$index_name "
+                " left join rdb$relation_constraints rc "
+                "   on rc.rdb$index_name = i.rdb$index_name "
+                + std::string(allTables ? " where i.rdb$relation_name is not null "
+                    : " where i.rdb$relation_name = ? ")
+                + " order by " + (allTables ? "i.rdb$relation_name, " : "")
+                + "i.rdb$index_name, s.rdb$field_position ";
+    }
+}
+
+void Table::clearDetails(DetailsType type)
+{
+    switch (type)
+    {
+        case dtPrimaryKey:
+            primaryKeyM.columnsM.clear();
+            primaryKeyM.setParent(this);
+            break;
+        case dtUniqueConstraints:
+            uniqueConstraintsM.clear();
+            break;
+        case dtForeignKeys:
+            foreignKeysM.clear();
+            break;
+        case dtCheckConstraints:
+            checkConstraintsM.clear();
+            break;
+        default:
+            indicesM.clear();
+            break;
+    }
+    getDetailsLoaded(type) = true;
+}
+
+bool Table::readDetails(DetailsType type, MetadataRows& rows)
+{
+    wxMBConv* conv = getDatabase()->getCharsetConverter();
+    bool more;
+    do
+    {
+        switch (type)
         {
-            ForeignKey fk;
-            foreignKeysM.push_back(fk);
-            fkp = &foreignKeysM.back();
-            fkp->setName_(cname);
-            fkp->setParent(this);
-            fkp->updateActionM = update_rule;
-            fkp->deleteActionM = delete_rule;
-            fkp->indexNameM = ixname;
-
-            st2->Set(1, ref_constraint);
-            st2->Execute();
-            std::string rtable;
-            while (st2->Fetch())
-            {
-                st2->Get(1, rtable);
-                st2->Get(2, s);
-                fkp->referencedColumnsM.push_back(std2wxIdentifier(s, conv));
-            }
-            fkp->referencedTableM = std2wxIdentifier(rtable, conv);
-            fkp->columnsM.push_back(fname);
+            case dtPrimaryKey:
+                readPrimaryKeyRow(rows, conv);
+                break;
+            case dtUniqueConstraints:
+                readUniqueConstraintRow(rows, conv);
+                break;
+            case dtForeignKeys:
+                readForeignKeyRow(rows, conv);
+                break;
+            case dtCheckConstraints:
+                readCheckConstraintRow(rows, conv);
+                break;
+            default:
+                readIndexRow(rows, conv);
+                break;
         }
+        more = rows.fetch();
     }
-    foreignKeysLoadedM = true;
+    while (more && getRelationName(rows, conv) == getName_());
+    return more;
 }
 
-//! reads indices from database
-void Table::loadIndices()
+void Table::readCheckConstraintRow(const MetadataRows& rows, wxMBConv* conv)
 {
-    if (indicesLoadedM)
-        return;
-    indicesM.clear();
+    wxString cname(std2wxIdentifier(rows.getString(1), conv));
+    if (checkConstraintsM.empty()
+        || cname != checkConstraintsM.back().getName_()) // new constraint
+    {
+        wxString source;
+        readBlob(rows, 2, source, conv);
+
+        CheckConstraint c;
+        c.setParent(this);
+        c.setName_(cname);
+        c.sourceM = source;
+        checkConstraintsM.push_back(c);
+    }
 
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
+    if (!rows.isNull(3))
+    {
+        wxString fname(std2wxIdentifier(rows.getString(3), conv));
+        checkConstraintsM.back().columnsM.push_back(fname);
+    }
+}
 
-    IBPP::Statement& st1 = loader->getStatement(
-        "SELECT i.rdb$index_name, i.rdb$unique_flag, i.rdb$index_inactive, "
-        " i.rdb$index_type, i.rdb$statistics, "
-        " s.rdb$field_name, rc.rdb$constraint_name, i.rdb$expression_source "
-        " from rdb$indices i "
-        " left join rdb$index_segments s on i.rdb$index_name = s.rdb$index_name "
-        " left join rdb$relation_constraints rc "
-        "   on rc.rdb$index_name = i.rdb$index_name "
-        " where i.rdb$relation_name = ? "
-        " order by i.rdb$index_name, s.rdb$field_position "
-    );
+void Table::readPrimaryKeyRow(const MetadataRows& rows, wxMBConv* conv)
+{
+    wxString cname(std2wxIdentifier(rows.getString(1), conv));
+    wxString fname(std2wxIdentifier(rows.getString(2), conv));
+    wxString ixname(std2wxIdentifier(rows.getString(3), conv));
 
-    st1->Set(1, wx2std(getName_(), conv));
-    st1->Execute();
-    Index* i = 0;
-    while (st1->Fetch())
+    primaryKeyM.setName_(cname);
+    primaryKeyM.columnsM.push_back(fname);
+    primaryKeyM.indexNameM = ixname;
+}
+
+void Table::readUniqueConstraintRow(const MetadataRows& rows, wxMBConv* conv)
+{
+    wxString cname(std2wxIdentifier(rows.getString(1), conv));
+    wxString fname(std2wxIdentifier(rows.getString(2), conv));
+    wxString ixname(std2wxIdentifier(rows.getString(3), conv));
+
+    if (!uniqueConstraintsM.empty()
+        && uniqueConstraintsM.back().getName_() == cname)
+    {
+        uniqueConstraintsM.back().columnsM.push_back(fname);
+    }
+    else
     {
-        std::string s;
-        st1->Get(1, s);
-        wxString ixname(std2wxIdentifier(s, conv));
+        UniqueConstraint c;
+        uniqueConstraintsM.push_back(c);
+        UniqueConstraint* cc = &uniqueConstraintsM.back();
+        cc->indexNameM = ixname;
+        cc->setName_(cname);
+        cc->columnsM.push_back(fname);
+        cc->setParent(this);
+    }
+}
 
-        short unq, inactive, type;
-        if (st1->IsNull(2))     // null = non-unique
-            unq = 0;
-        else
-            st1->Get(2, unq);
-        if (st1->IsNull(3))     // null = active
-            inactive = 0;
-        else
-            st1->Get(3, inactive);
-        if (st1->IsNull(4))     // null = ascending
-            type = 0;
-        else
-            st1->Get(4, type);
-        double statistics;
-        if (st1->IsNull(5))     // this can happen, see bug #1825725
-            statistics = -1;
-        else
-            st1->Get(5, statistics);
+void Table::readForeignKeyRow(const MetadataRows& rows, wxMBConv* conv)
+{
+    wxString cname(std2wxIdentifier(rows.getString(1), conv));
+    wxString fname(std2wxIdentifier(rows.getString(2), conv));
 
-        st1->Get(6, s);
-        wxString fname(std2wxIdentifier(s, conv));
-        wxString expression;
-        readBlob(st1, 8, expression, conv);
+    ForeignKey* fkp;
+    if (!foreignKeysM.empty() && foreignKeysM.back().getName_() == cname)
+        fkp = &foreignKeysM.back();     // add column
+    else
+    {
+        wxString update_rule(std2wxIdentifier(rows.getString(3), conv));
+        wxString delete_rule(std2wxIdentifier(rows.getString(4), conv));
+        wxString ixname(std2wxIdentifier(rows.getString(6), conv));
+
+        ForeignKey fk;
+        foreignKeysM.push_back(fk);
+        fkp = &foreignKeysM.back();
+        fkp->setName_(cname);
+        fkp->setParent(this);
+        fkp->updateActionM = update_rule;
+        fkp->deleteActionM = delete_rule;
+        fkp->indexNameM = ixname;
+        if (!rows.isNull(7))
+            fkp->referencedTableM = std2wxIdentifier(rows.getString(7), conv);
+    }
+    fkp->columnsM.push_back(fname);
+    if (!rows.isNull(8))
+    {
+        fkp->referencedColumnsM.push_back(
+            std2wxIdentifier(rows.getString(8), conv));
+    }
+}
 
-        if (i && i->getName_() == ixname)
-            i->getSegments()->push_back(fname);
-        else
-        {
-            Index x(
-                unq == 1,
-                inactive == 0,
-                type == 0,
-                statistics,
-                !st1->IsNull(7),
-                expression
-            );
-            indicesM.push_back(x);
-            i = &indicesM.back();
-            i->setName_(ixname);
-            i->getSegments()->push_back(fname);
-            i->setParent(this);
-        }
+void Table::readIndexRow(const MetadataRows& rows, wxMBConv* conv)
+{
+    wxString ixname(std2wxIdentifier(rows.getString(1), conv));
+
+    // null = non-unique, active and ascending
+    short unq = short(rows.getInt(2));
+    short inactive = short(rows.getInt(3));
+    short type = short(rows.getInt(4));
+    double statistics;
+    if (rows.isNull(5))     // this can happen, see bug #1825725
+        statistics = -1;
+    else
+        statistics = rows.getDouble(5);
+
+    wxString fname(std2wxIdentifier(rows.getString(6), conv));
+    wxString expression;
+    readBlob(rows, 8, expression, conv);
+
+    if (!indicesM.empty() && indicesM.back().getName_() == ixname)
+        indicesM.back().getSegments()->push_back(fname);
+    else
+    {
+        Index x(
+            unq == 1,
+            inactive == 0,
+            type == 0,
+            statistics,
+            !rows.isNull(7),
+            expression
+        );
+        indicesM.push_back(x);
+        Index* i = &indicesM.back();
+        i->setName_(ixname);
+        i->getSegments()->push_back(fname);
+        i->setParent(this);
     }
-    indicesLoadedM = true;
 }
 
 const wxString Table::getTypeName() const
@@ -525,10 +529,16 @@ bool SysTables::isSystem() const
 
 void SysTables::load(ProgressIndicator* progressIndicator)
 {
-    wxString stmt = "select rdb$relation_name from rdb$relations"
+    loadItems(progressIndicator);
+}
+
+wxArrayString SysTables::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select rdb$relation_name from rdb$relations"
         " where rdb$system_flag = 1"
-        " and rdb$view_source is null order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        " and rdb$view_source is null order by 1");
+    return statements;
 }
 
 void SysTables::loadChildren()
@@ -554,13 +564,19 @@ void Tables::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Tables::load(ProgressIndicator* progressIndicator)
 {
-    
+    loadItems(progressIndicator);
+}
+
+wxArrayString Tables::getLoadStatements() const
+{
     wxString stmt = "select rdb$relation_name from rdb$relations "
         "where  (rdb$system_flag = 0 or rdb$system_flag is null) ";
     if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(11.1))
         stmt += " and  (rdb$relation_type in (0, 2)  or rdb$relation_type is null)";
     stmt += " and rdb$view_source is null order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    wxArrayString statements;
+    statements.push_back(stmt);
+    return statements;
 }
 
 void Tables::loadChildren()
@@ -586,12 +602,18 @@ void GTTables::acceptVisitor(MetadataItemVisitor* visitor)
 
 void GTTables::load(ProgressIndicator* progressIndicator)
 {
+    loadItems(progressIndicator);
+}
+
+wxArrayString GTTables::getLoadStatements() const
+{
+    wxArrayString statements;
     if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(11.1)) {
-        wxString stmt = "select rdb$relation_name from rdb$relations"
+        statements.push_back("select rdb$relation_name from rdb$relations"
             " where rdb$relation_type in (4,5) "
-            " and rdb$view_source is null order by 1";
-        setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+            " and rdb$view_source is null order by 1");
     }
+    return statements;
 }
 
 void GTTables::loadChildren()
@@ -32,6 +32,13 @@
 
 class Table: public Relation
 {
+public:
+    // needs to be declared here as type is used in private section
+    // details loaded on demand, each with a single statement that can load
+    // them for all tables at once as well
+    enum DetailsType { dtPrimaryKey, dtUniqueConstraints, dtForeignKeys,
+        dtCheckConstraints, dtIndices };
+
 private:
     PrimaryKeyConstraint primaryKeyM;           // table can have only one pk
     bool primaryKeyLoadedM;
@@ -53,6 +60,14 @@ private:
     bool indicesLoadedM;
     void loadIndices();
 
+    void readCheckConstraintRow(const MetadataRows& rows, wxMBConv* conv);
+    void readPrimaryKeyRow(const MetadataRows& rows, wxMBConv* conv);
+    void readUniqueConstraintRow(const MetadataRows& rows, wxMBConv* conv);
+    void readForeignKeyRow(const MetadataRows& rows, wxMBConv* conv);
+    void readIndexRow(const MetadataRows& rows, wxMBConv* conv);
+    bool& getDetailsLoaded(DetailsType type);
+    void loadDetails(DetailsType type);
+
     wxString externalPathM;
 
 protected:
@@ -63,6 +78,14 @@ protected:
 public:
     Table(DatabasePtr database, const wxString& name);
 
+    static std::string getDetailsStatement(DetailsType type,
+        bool allTables);
+    // sets the details to empty and loaded, then readDetails() reads them
+    // from the current row and all following rows of this table, and
+    // returns false if no rows are left
+    void clearDetails(DetailsType type);
+    bool readDetails(DetailsType type, MetadataRows& rows);
+
     static bool tablesRelate(const std::vector<wxString>& tables,
         Table *table, std::vector<ForeignKey>& list);
 
@@ -105,6 +128,7 @@ public:
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     virtual bool isSystem() const;
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -117,6 +141,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -129,6 +154,7 @@ public:
 
     virtual void acceptVisitor(MetadataItemVisitor* visitor);
     void load(ProgressIndicator* progressIndicator);
+    virtual wxArrayString getLoadStatements() const;
     virtual const wxString getTypeName() const;
 };
 
@@ -390,14 +390,19 @@ void DMLTriggers::acceptVisitor(MetadataItemVisitor* visitor)
 
 void DMLTriggers::load(ProgressIndicator* progressIndicator)
 {
+    loadItems(progressIndicator);
+}
+
+wxArrayString DMLTriggers::getLoadStatements() const
+{
+    wxArrayString statements;
     wxString stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null) "
         " and rdb$relation_name is not null  ";
     if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
         stmt += "and BIN_AND(rdb$trigger_type,"+ std::to_string(TRIGGER_TYPE_MASK)+") = "+ std::to_string(TRIGGER_TYPE_DML);
     stmt += " order by 1";
-
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    statements.push_back(stmt);
 
     stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null)  and rdb$trigger_inactive = 1"
@@ -405,8 +410,8 @@ void DMLTriggers::load(ProgressIndicator* progressIndicator)
     if (getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
         stmt += "and BIN_AND(rdb$trigger_type," + std::to_string(TRIGGER_TYPE_MASK) + ") = " + std::to_string(TRIGGER_TYPE_DML);
     stmt += " order by 1";
-
-    setInactiveItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    statements.push_back(stmt);
+    return statements;
 }
 
 void DMLTriggers::loadChildren()
@@ -432,19 +437,27 @@ void DBTriggers::acceptVisitor(MetadataItemVisitor* visitor)
 
 void DBTriggers::load(ProgressIndicator* progressIndicator)
 {
+    loadItems(progressIndicator);
+}
+
+wxArrayString DBTriggers::getLoadStatements() const
+{
+    wxArrayString statements;
+    if (!getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(11, 1))
+        return statements;
+
     wxString stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null) "
         " and BIN_AND(rdb$trigger_type," + std::to_string(TRIGGER_TYPE_MASK) + ") = " + std::to_string(TRIGGER_TYPE_DB)+
         " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator)); 
+    statements.push_back(stmt);
 
     stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null) and rdb$trigger_inactive = 1"
         " and BIN_AND(rdb$trigger_type," + std::to_string(TRIGGER_TYPE_MASK) + ") = " + std::to_string(TRIGGER_TYPE_DB) +
         " order by 1";
-
-    setInactiveItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
-
+    statements.push_back(stmt);
+    return statements;
 }
 
 
@@ -473,18 +486,27 @@ void DDLTriggers::acceptVisitor(MetadataItemVisitor* visitor)
 
 void DDLTriggers::load(ProgressIndicator* progressIndicator)
 {
+    loadItems(progressIndicator);
+}
+
+wxArrayString DDLTriggers::getLoadStatements() const
+{
+    wxArrayString statements;
+    if (!getDatabase()->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+        return statements;
+
     wxString stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null) "
         " and BIN_AND(rdb$trigger_type," + std::to_string(TRIGGER_TYPE_MASK) + ") = " + std::to_string(TRIGGER_TYPE_DDL) +
         " order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    statements.push_back(stmt);
 
     stmt = "select rdb$trigger_name from rdb$triggers"
         " where (rdb$system_flag = 0 or rdb$system_flag is null) and rdb$trigger_inactive = 1 "
         " and BIN_AND(rdb$trigger_type," + std::to_string(TRIGGER_TYPE_MASK) + ") = " + std::to_string(TRIGGER_TYPE_DDL) +
         " order by 1";
-
-    setInactiveItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+    statements.push_back(stmt);
+    return statements;
 }
 
 void DDLTriggers::loadChildren()
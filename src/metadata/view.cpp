@@ -122,10 +122,16 @@ void Views::acceptVisitor(MetadataItemVisitor* visitor)
 
 void Views::load(ProgressIndicator* progressIndicator)
 {
-    wxString stmt = "select rdb$relation_name from rdb$relations"
+    loadItems(progressIndicator);
+}
+
+wxArrayString Views::getLoadStatements() const
+{
+    wxArrayString statements;
+    statements.push_back("select rdb$relation_name from rdb$relations"
         " where (rdb$system_flag = 0 or rdb$system_flag is null)"
-        " and rdb$view_source is not null order by 1";
-    setItems(getDatabase()->loadIdentifiers(stmt, progressIndicator));
+        " and rdb$view_source is not null order by 1");
+    return statements;
 }
 
 void Views::loadChildren()
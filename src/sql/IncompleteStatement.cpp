@@ -30,6 +30,8 @@
     #include "wx/wx.h"
 #endif
 
+#include <list>
+
 #include "config/Config.h"
 #include "metadata/column.h"
 #include "metadata/database.h"
@@ -41,8 +43,9 @@
 #include "sql/MultiStatement.h"
 #include "sql/SqlTokenizer.h"
 
-IncompleteStatement::IncompleteStatement(Database *db, const wxString& sql)
-    :databaseM(db), sqlM(sql)
+IncompleteStatement::IncompleteStatement(Database *db, const wxString& sql,
+        StatementIndex* index)
+    :databaseM(db), sqlM(sql), statementIndexM(index)
 {
 }
 
@@ -50,9 +53,12 @@ IncompleteStatement::IncompleteStatement(Database *db, const wxString& sql)
 wxString IncompleteStatement::getObjectColumns(const wxString& table,
     int position, bool sortColums)
 {
-    MultiStatement ms(sqlM);
     int offset;
-    SingleStatement st = ms.getStatementAt(position, offset);
+    SingleStatement st;
+    if (statementIndexM)
+        st = statementIndexM->getStatementAt(sqlM, position, offset);
+    else
+        st = MultiStatement(sqlM).getStatementAt(position, offset);
     if (!st.isValid())
         return wxEmptyString;
 
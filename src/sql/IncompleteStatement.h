@@ -26,6 +26,7 @@
 
 class Database;
 class Relation;
+class StatementIndex;
 
 //! Provides various information for incomplete (partial) sql statements
 //! Used mostly for autocomplete stuff
@@ -34,6 +35,7 @@ class IncompleteStatement
 private:
     Database* databaseM;
     wxString sqlM;
+    StatementIndex* statementIndexM;
 
     Relation* getCreateTriggerRelation(const wxString& sql);
     Relation* getAlterTriggerRelation(const wxString& sql);
@@ -46,7 +48,9 @@ private:
         const wxString& alias, NodeType type);
 
 public:
-    IncompleteStatement(Database* db, const wxString& sql);
+    // statements are looked up in index if given, it is updated as needed
+    IncompleteStatement(Database* db, const wxString& sql,
+        StatementIndex* index = 0);
 
     // position is offset at which user typed the dot character
     wxString getObjectColumns(const wxString& table, int position, bool sortColums);
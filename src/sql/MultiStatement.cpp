@@ -293,3 +293,167 @@ int MultiStatement::getEnd() const
     return lastPosM - sqlM.begin();
 }
 
+int MultiStatement::getNextStart() const
+{
+    if (atEndM)
+        return sqlM.length();
+    return searchPosM - sqlM.begin();
+}
+
+void MultiStatement::setNextStart(int position)
+{
+    oldPosM = searchPosM = sqlM.begin() + position;
+    atEndM = false;
+}
+
+StatementIndex::StatementIndex(const wxString& terminator)
+    : terminatorM(terminator), textLengthM(0), validM(false),
+      damagedM(false), damageStartM(0), damageEndM(0), damageDeltaM(0)
+{
+}
+
+void StatementIndex::startDamage(int position)
+{
+    if (!damagedM)
+    {
+        damagedM = true;
+        damageStartM = damageEndM = position;
+        damageDeltaM = 0;
+    }
+    damageStartM = std::min(damageStartM, position);
+}
+
+void StatementIndex::textInserted(int position, int length)
+{
+    if (!validM)
+        return;
+    startDamage(position);
+    // text after the changed part stays unchanged, merging the changes
+    // only has to keep that true
+    if (position <= damageEndM)
+        damageEndM += length;
+    else
+        damageEndM = position + length;
+    damageDeltaM += length;
+}
+
+void StatementIndex::textDeleted(int position, int length)
+{
+    if (!validM)
+        return;
+    startDamage(position);
+    if (damageEndM >= position + length)
+        damageEndM -= length;
+    else
+        damageEndM = position;
+    damageDeltaM -= length;
+}
+
+void StatementIndex::update(const wxString& text)
+{
+    if (validM && !damagedM)
+        return;
+
+    // the statements ending before the changed part are still valid, and
+    // those after it only need to be moved; if changes were missed the
+    // whole text is split again
+    const int oldLen = textLengthM, newLen = text.length();
+    if (validM && newLen != oldLen + damageDeltaM)
+        validM = false;
+    int damageStart = 0, damageEndOld = oldLen, damageEndNew = newLen;
+    if (validM)
+    {
+        damageStart = damageStartM;
+        damageEndNew = damageEndM;
+        damageEndOld = damageEndM - damageDeltaM;
+    }
+    damagedM = false;
+    const int delta = newLen - oldLen;
+
+    std::vector<Entry> oldEntries;
+    oldEntries.swap(entriesM);
+    size_t k = 0;
+    if (validM)
+    {
+        while (k < oldEntries.size() && oldEntries[k].nextStart <= damageStart)
+            ++k;
+        // the last of them may have stopped at the end of the old text
+        if (k > 0 && oldEntries[k - 1].nextStart == oldLen)
+            --k;
+    }
+    entriesM.assign(oldEntries.begin(), oldEntries.begin() + k);
+
+    MultiStatement ms(text, k > 0 ? oldEntries[k - 1].nextTerminator
+        : terminatorM);
+    ms.setNextStart(k > 0 ? oldEntries[k - 1].nextStart : 0);
+    // index of the next unchanged old statement to compare with
+    size_t j = k;
+    // a terminator at the very end isn't followed by an empty statement
+    while (k == 0 || ms.getNextStart() < newLen)
+    {
+        SingleStatement s = ms.getNextStatement();
+        if (!s.isValid())
+            break;
+        Entry e = { ms.getStart(), ms.getEnd(), ms.getNextStart(),
+            ms.getTerminator() };
+        entriesM.push_back(e);
+        // an empty terminator is reported to the caller when executing,
+        // nothing after it can be split
+        if (e.nextStart >= newLen || e.nextTerminator.empty())
+            break;
+
+        // once the search is in the same state as after an old statement
+        // in the unchanged part, the following old statements still apply
+        if (e.nextStart < damageEndNew)
+            continue;
+        while (j < oldEntries.size()
+            && oldEntries[j].nextStart + delta < e.nextStart)
+        {
+            ++j;
+        }
+        if (j < oldEntries.size()
+            && oldEntries[j].nextStart >= damageEndOld
+            && oldEntries[j].nextStart + delta == e.nextStart
+            && oldEntries[j].nextTerminator == e.nextTerminator)
+        {
+            for (++j; j < oldEntries.size(); ++j)
+            {
+                Entry shifted = oldEntries[j];
+                shifted.start += delta;
+                shifted.end += delta;
+                shifted.nextStart += delta;
+                entriesM.push_back(shifted);
+            }
+            break;
+        }
+    }
+
+    textLengthM = newLen;
+    validM = true;
+}
+
+SingleStatement StatementIndex::getStatementAt(const wxString& text,
+    int position, int& offset)
+{
+    update(text);
+
+    // first statement ending at or after position
+    size_t lo = 0, hi = entriesM.size();
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (entriesM[mid].end < position)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == entriesM.size())
+    {
+        offset = entriesM.empty() ? 0 : entriesM.back().start;
+        return SingleStatement();
+    }
+    offset = entriesM[lo].start;
+    return SingleStatement(text.substr(entriesM[lo].start,
+        entriesM[lo].end - entriesM[lo].start));
+}
+
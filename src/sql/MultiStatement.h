@@ -24,6 +24,8 @@
 #ifndef FR_MULTI_STATEMENT_H
 #define FR_MULTI_STATEMENT_H
 
+#include <vector>
+
 class SingleStatement
 {
 private:
@@ -70,9 +72,55 @@ public:
     // get positions of last statement retrieved
     int getStart() const;
     int getEnd() const;
+    // position where the search for the next statement starts
+    int getNextStart() const;
+    // continue the search for statements at the given position
+    void setNextStart(int position);
 
     wxString getTerminator() const;
     void setTerminator(const wxString& newTerm);
 };
 
+// Keeps the positions of all statements in a text, to find the statement
+// at a position without splitting the whole text every time. The editor
+// reports every insertion and deletion, and only the statements from the
+// first changed character up to where the statement boundaries are the
+// same again are split anew.
+class StatementIndex
+{
+private:
+    struct Entry
+    {
+        int start;
+        int end;
+        // state of the search after this statement
+        int nextStart;
+        wxString nextTerminator;
+    };
+    std::vector<Entry> entriesM;
+    wxString terminatorM;
+    // length of the text the entries were created for
+    int textLengthM;
+    bool validM;
+    // the part of the current text that changed since the entries were
+    // created, and by how much the text length changed
+    bool damagedM;
+    int damageStartM;
+    int damageEndM;
+    int damageDeltaM;
+
+    void startDamage(int position);
+    void update(const wxString& text);
+public:
+    StatementIndex(const wxString& terminator = ";");
+
+    // to be called for every change of the text, positions and lengths
+    // are in characters
+    void textInserted(int position, int length);
+    void textDeleted(int position, int length);
+    // works like MultiStatement::getStatementAt() for the given text
+    SingleStatement getStatementAt(const wxString& text, int position,
+        int& offset);
+};
+
 #endif
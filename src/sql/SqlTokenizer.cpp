@@ -31,6 +31,8 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "config/Config.h"
 #include "sql/SqlTokenizer.h"
@@ -62,6 +64,211 @@ public:
     }
 };
 
+// character classes of the ASCII range, wxIsspace() is only needed for the
+// characters above it
+enum { ccSpace = 1, ccIdentStart = 2, ccIdent = 4 };
+
+class SqlCharClasses
+{
+private:
+    unsigned char classesM[128];
+public:
+    SqlCharClasses()
+    {
+        for (int c = 0; c < 128; c++)
+        {
+            classesM[c] = 0;
+            if (c == ' ' || (c >= '\t' && c <= '\r'))
+                classesM[c] |= ccSpace;
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+                classesM[c] |= ccIdentStart | ccIdent;
+            if ((c >= '0' && c <= '9') || c == '_' || c == '$')
+                classesM[c] |= ccIdent;
+        }
+    }
+
+    static const SqlCharClasses& get()
+    {
+        static SqlCharClasses scc;
+        return scc;
+    }
+
+    inline bool is(wxChar c, int charClass) const
+    {
+        return unsigned(c) < 128 && (classesM[unsigned(c)] & charClass) != 0;
+    }
+
+    inline bool isSpace(wxChar c) const
+    {
+        if (unsigned(c) < 128)
+            return (classesM[unsigned(c)] & ccSpace) != 0;
+        return wxIsspace(c) != 0;
+    }
+};
+
+// KeywordTable: minimal perfect hash of the keywords, built once from
+// keywordtokens.hpp.  The keywords are first hashed into buckets, then for
+// every bucket (largest first) a seed is searched that moves all of its
+// keywords to free slots.  Buckets with a single keyword store the slot
+// directly.  A lookup hashes the word twice and compares one slot, case is
+// folded while hashing so no upper-cased copy of the word is needed.
+class KeywordTable
+{
+private:
+    struct Slot
+    {
+        const char* name;
+        size_t length;
+        SqlTokenType type;
+    };
+    std::vector<Slot> slotsM;
+    // seed for the bucket, or -1 - slot index for single keyword buckets
+    std::vector<int> bucketsM;
+
+    static inline unsigned upper(unsigned c)
+    {
+        return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+    }
+
+    template <typename T>
+    static unsigned hash(unsigned seed, const T* p, size_t length)
+    {
+        unsigned h = 2166136261u ^ (seed * 16777619u);
+        for (size_t i = 0; i < length; i++)
+            h = (h ^ upper(unsigned(p[i]))) * 16777619u;
+        return h ^ (h >> 15);
+    }
+
+    size_t find(const wxChar* p, size_t length) const
+    {
+        int bucket = bucketsM[hash(0, p, length) % bucketsM.size()];
+        if (bucket < 0)
+            return -1 - bucket;
+        return hash(bucket, p, length) % slotsM.size();
+    }
+
+    KeywordTable()
+    {
+        static const struct { const char* name; SqlTokenType type; } entries[] =
+        {
+            #include "keywordtokens.hpp"
+            { "", tkUNKNOWN }
+        };
+        // the first of several entries for the same keyword is used
+        std::vector<Slot> keywords;
+        for (int i = 0; entries[i].type != tkUNKNOWN; i++)
+        {
+            Slot s = { entries[i].name, strlen(entries[i].name),
+                entries[i].type };
+            bool duplicate = false;
+            for (size_t j = 0; j < keywords.size() && !duplicate; j++)
+            {
+                duplicate = keywords[j].length == s.length
+                    && equals(keywords[j].name, s.name, s.length, true);
+            }
+            if (!duplicate)
+                keywords.push_back(s);
+        }
+        if (keywords.empty())
+            return;
+
+        const size_t n = keywords.size();
+        std::vector<std::vector<size_t> > buckets((n + 3) / 4);
+        for (size_t i = 0; i < n; i++)
+        {
+            buckets[hash(0, keywords[i].name, keywords[i].length)
+                % buckets.size()].push_back(i);
+        }
+        std::vector<size_t> order(buckets.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+            [&buckets](size_t a, size_t b)
+            { return buckets[a].size() > buckets[b].size(); });
+
+        Slot empty = { 0, 0, tkIDENTIFIER };
+        slotsM.assign(n, empty);
+        bucketsM.assign(buckets.size(), 0);
+        std::vector<bool> used(n, false);
+        size_t freeSlot = 0;
+        for (size_t b : order)
+        {
+            const std::vector<size_t>& bucket = buckets[b];
+            if (bucket.empty())
+                break;
+            if (bucket.size() == 1)
+            {
+                while (used[freeSlot])
+                    freeSlot++;
+                used[freeSlot] = true;
+                slotsM[freeSlot] = keywords[bucket[0]];
+                bucketsM[b] = -1 - int(freeSlot);
+                continue;
+            }
+            for (int seed = 1; ; seed++)
+            {
+                std::vector<size_t> slots;
+                for (size_t i : bucket)
+                {
+                    size_t slot = hash(seed, keywords[i].name,
+                        keywords[i].length) % n;
+                    if (used[slot] || std::find(slots.begin(), slots.end(),
+                        slot) != slots.end())
+                    {
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (slots.size() != bucket.size())
+                    continue;
+                for (size_t i = 0; i < slots.size(); i++)
+                {
+                    used[slots[i]] = true;
+                    slotsM[slots[i]] = keywords[bucket[i]];
+                }
+                bucketsM[b] = seed;
+                break;
+            }
+        }
+    }
+
+    template <typename T>
+    static bool equals(const char* keyword, const T* p, size_t length,
+        bool ignoreCase)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned c = unsigned(p[i]);
+            if (ignoreCase)
+                c = upper(c);
+            if (upper(unsigned(keyword[i])) != c)
+                return false;
+        }
+        return true;
+    }
+public:
+    static const KeywordTable& get()
+    {
+        static KeywordTable kt;
+        return kt;
+    }
+
+    // returns tkIDENTIFIER if the word is no keyword
+    SqlTokenType getTokenType(const wxChar* p, size_t length,
+        bool ignoreCase) const
+    {
+        if (length == 0 || slotsM.empty())
+            return tkIDENTIFIER;
+        const Slot& slot = slotsM[find(p, length)];
+        if (slot.length != length
+            || !equals(slot.name, p, length, ignoreCase))
+        {
+            return tkIDENTIFIER;
+        }
+        return slot.type;
+    }
+};
+
 SqlTokenizer::SqlTokenizer()
     : termM(";")
 {
@@ -181,25 +388,17 @@ wxString SqlTokenizer::getKeywordsString(KeywordCase kwc)
 /*static*/
 SqlTokenType SqlTokenizer::getKeywordTokenType(const wxString& word)
 {
-    if (word.IsEmpty())
-        return tkIDENTIFIER;
-
-    const KeywordToTokenMap& keywords = getKeywordToTokenMap();
-    KeywordToTokenMap::const_iterator pos = keywords.find(word.Upper());
-    if (pos != keywords.end())
-        return (*pos).second;
-    return tkIDENTIFIER;
+    const wxChar* p = word.c_str();
+    return KeywordTable::get().getTokenType(p, word.length(), true);
 }
 
 /*static*/
 bool SqlTokenizer::isReservedWord(const wxString& word)
 {
-    if (word.IsEmpty())
-        return false;
-
-    const KeywordToTokenMap& keywords = getKeywordToTokenMap();
-    KeywordToTokenMap::const_iterator pos = keywords.find(word);
-    return pos != keywords.end();
+    // keywords are only recognized in upper case here
+    const wxChar* p = word.c_str();
+    return KeywordTable::get().getTokenType(p, word.length(), false)
+        != tkIDENTIFIER;
 }
 
 SqlTokenType SqlTokenizer::getCurrentToken()
@@ -279,7 +478,7 @@ bool SqlTokenizer::nextToken()
         multilineCommentToken();
     else if (c == '-' && *(sqlTokenEndM + 1) == '-')
         singleLineCommentToken();
-    else if (wxIsspace(c))
+    else if (SqlCharClasses::get().isSpace(c))
         whitespaceToken();
     else
         defaultToken();
@@ -312,7 +511,7 @@ void SqlTokenizer::defaultToken()
             || *sqlTokenEndM == '(' || *sqlTokenEndM == ')'
             || *sqlTokenEndM == '+' || *sqlTokenEndM == '-'
             || *sqlTokenEndM == '/' || *sqlTokenEndM == '*'
-            || wxIsspace(*sqlTokenEndM)
+            || SqlCharClasses::get().isSpace(*sqlTokenEndM)
             || wxStricmp(sqlTokenEndM, termM.c_str()) == 0  )
         {
             break;
@@ -326,21 +525,15 @@ void SqlTokenizer::keywordIdentifierToken()
     sqlTokenTypeM = tkIDENTIFIER;
     // identifier must start with letter 'a'..'z', and may continue with
     // those same letters, numbers and the characters '_' and '$'
-    wxChar c = *sqlTokenEndM;
-    wxASSERT((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'));
+    const SqlCharClasses& scc = SqlCharClasses::get();
+    wxASSERT(scc.is(*sqlTokenEndM, ccIdentStart));
     do
-    {
         sqlTokenEndM++;
-        c = *sqlTokenEndM;
-    }
-    while (c != 0 && ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
-        || (c >= '0' && c <= '9') || c == '_' || c == '$'));
+    while (scc.is(*sqlTokenEndM, ccIdent));
 
     // check whether it's a keyword, and not an identifier
-    wxString checkKW(sqlTokenStartM, sqlTokenEndM);
-    SqlTokenType keywordType = getKeywordTokenType(checkKW);
-    if (keywordType != tkIDENTIFIER)
-        sqlTokenTypeM = keywordType;
+    sqlTokenTypeM = KeywordTable::get().getTokenType(sqlTokenStartM,
+        sqlTokenEndM - sqlTokenStartM, true);
 }
 
 void SqlTokenizer::multilineCommentToken()
@@ -426,10 +619,11 @@ inline void SqlTokenizer::symbolToken(SqlTokenType type)
 void SqlTokenizer::whitespaceToken()
 {
     sqlTokenTypeM = tkWHITESPACE;
-    wxASSERT(wxIsspace(*sqlTokenEndM));
+    const SqlCharClasses& scc = SqlCharClasses::get();
+    wxASSERT(scc.isSpace(*sqlTokenEndM));
     sqlTokenEndM++;
     // scan until non-whitespace, or until "\0" found
-    while (*sqlTokenEndM != 0 && wxIsspace(*sqlTokenEndM))
+    while (*sqlTokenEndM != 0 && scc.isSpace(*sqlTokenEndM))
         sqlTokenEndM++;
 }
 
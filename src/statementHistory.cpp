@@ -32,13 +32,94 @@
 
 #include <wx/ffile.h>
 #include <wx/filefn.h>
+
+#include <algorithm>
 #include <map>
+#include <set>
+#include <string>
 
 #include "config/Config.h"
 #include "metadata/database.h"
 #include "statementHistory.h"
 
+namespace
+{
+    // log records consist of the length (4 bytes) and time (8 bytes) of the
+    // statement followed by its UTF-8 text, index entries of the offset of
+    // the record in the log (8 bytes), the length and the time
+    const size_t recordHeaderSize = 12;
+    const size_t indexEntrySize = 20;
+
+    void appendUInt(std::string& buffer, wxUint64 value, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i, value >>= 8)
+            buffer += char(value & 0xFF);
+    }
+
+    wxUint64 readUInt(const char* p, size_t bytes)
+    {
+        wxUint64 value = 0;
+        for (size_t i = bytes; i > 0; --i)
+            value = (value << 8) | (unsigned char)p[i - 1];
+        return value;
+    }
+
+    bool readStatement(wxFFile& log, wxFileOffset offset, size_t length,
+        wxString& statement)
+    {
+        std::string buffer(length, '\0');
+        if (!log.Seek(offset + recordHeaderSize))
+            return false;
+        if (length && log.Read(&buffer[0], length) != length)
+            return false;
+        statement = wxString::FromUTF8(buffer.data(), length);
+        return true;
+    }
+
+    bool writeFile(const wxString& fileName, const std::string& data)
+    {
+        wxString tempFileName(fileName + ".tmp");
+        wxFFile f(tempFileName, "wb");
+        if (!f.IsOpened())
+            return false;
+        bool written = f.Write(data.data(), data.size()) == data.size();
+        if (f.Close() && written && wxRenameFile(tempFileName, fileName, true))
+            return true;
+        wxRemoveFile(tempFileName);
+        return false;
+    }
+
+    // returns the words (letters, digits, '_' and '$') of the text
+    std::set<wxString> getTokens(const wxString& text)
+    {
+        std::set<wxString> tokens;
+        wxString token;
+        for (wxString::const_iterator it = text.begin(); ; ++it)
+        {
+            if (it != text.end()
+                && (wxIsalnum(*it) || *it == '_' || *it == '$'))
+            {
+                token += *it;
+                continue;
+            }
+            if (!token.empty())
+                tokens.insert(token);
+            token.clear();
+            if (it == text.end())
+                break;
+        }
+        return tokens;
+    }
+}
+
 wxString StatementHistory::getFilename(StatementHistory::Position item)
+{
+    wxString fn = getBaseFilename();
+    fn << "_ITEM_" << (item);
+    return fn;
+}
+
+wxString StatementHistory::getBaseFilename()
 {
     wxString fn = config().getUserHomePath() + "history/";
     if (!wxDirExists(fn))
@@ -46,26 +127,197 @@ wxString StatementHistory::getFilename(StatementHistory::Position item)
 
     for (Position i=0; i<storageNameM.Length(); ++i)
         fn += wxString::Format("%04x", storageNameM[i]);
-    fn << "_ITEM_" << (item);
     return fn;
 }
 
+wxString StatementHistory::getLogFilename()
+{
+    return getBaseFilename() + ".log";
+}
+
+wxString StatementHistory::getIndexFilename()
+{
+    return getBaseFilename() + ".idx";
+}
+
 StatementHistory::StatementHistory(const wxString& storageName)
+    : storageNameM(storageName), logSizeM(0), tokensLoadedM(false)
+{
+    if (!wxFileExists(getLogFilename()))
+        migrateLegacyItems();
+    else if (!readIndex())
+        rebuildIndex();
+}
+
+StatementHistory::StatementHistory(const StatementHistory& source)
+    : storageNameM(source.storageNameM), entriesM(source.entriesM),
+        logSizeM(source.logSizeM), tokensM(source.tokensM),
+        tokensLoadedM(source.tokensLoadedM)
+{
+}
+
+bool StatementHistory::readIndex()
+{
+    wxFFile log(getLogFilename(), "rb");
+    if (!log.IsOpened())
+        return false;
+    logSizeM = log.Length();
+    log.Close();
+
+    wxFFile f(getIndexFilename(), "rb");
+    if (!f.IsOpened())
+        return false;
+    std::string data(f.Length(), '\0');
+    if (data.size() % indexEntrySize != 0
+        || (!data.empty() && f.Read(&data[0], data.size()) != data.size()))
+    {
+        return false;
+    }
+
+    entriesM.clear();
+    entriesM.reserve(data.size() / indexEntrySize);
+    for (size_t pos = 0; pos < data.size(); pos += indexEntrySize)
+    {
+        Entry e;
+        e.offset = wxFileOffset(readUInt(&data[pos], 8));
+        e.length = size_t(readUInt(&data[pos + 8], 4));
+        e.timestamp = wxInt64(readUInt(&data[pos + 12], 8));
+        if (e.offset + wxFileOffset(recordHeaderSize + e.length) > logSizeM)
+            return false;
+        entriesM.push_back(e);
+    }
+    return true;
+}
+
+void StatementHistory::rebuildIndex()
 {
-    storageNameM = storageName;
-    sizeM = 0;
-    while (true)    // load history
+    // read all records from the log, dropping an incomplete last one
+    entriesM.clear();
+    logSizeM = 0;
+    wxFFile f(getLogFilename(), "rb");
+    if (!f.IsOpened())
+        return;
+    std::string data(f.Length(), '\0');
+    if (!data.empty() && f.Read(&data[0], data.size()) != data.size())
+        return;
+    f.Close();
+
+    size_t pos = 0;
+    while (pos + recordHeaderSize <= data.size())
     {
-        if (!wxFileExists(getFilename(sizeM)))
+        Entry e;
+        e.offset = wxFileOffset(pos);
+        e.length = size_t(readUInt(&data[pos], 4));
+        e.timestamp = wxInt64(readUInt(&data[pos + 4], 8));
+        if (pos + recordHeaderSize + e.length > data.size())
             break;
-        sizeM++;
+        entriesM.push_back(e);
+        pos += recordHeaderSize + e.length;
     }
+    logSizeM = wxFileOffset(pos);
+    writeIndex();
 }
 
-StatementHistory::StatementHistory(const StatementHistory& source)
+bool StatementHistory::writeIndex()
 {
-    storageNameM = source.storageNameM;
-    sizeM = source.sizeM;
+    std::string data;
+    data.reserve(entriesM.size() * indexEntrySize);
+    for (std::vector<Entry>::const_iterator it = entriesM.begin();
+        it != entriesM.end(); ++it)
+    {
+        appendUInt(data, wxUint64(it->offset), 8);
+        appendUInt(data, it->length, 4);
+        appendUInt(data, wxUint64(it->timestamp), 8);
+    }
+    return writeFile(getIndexFilename(), data);
+}
+
+void StatementHistory::migrateLegacyItems()
+{
+    // older versions kept every statement in a file of its own
+    Position count = 0;
+    while (wxFileExists(getFilename(count)))
+    {
+        wxFFile f(getFilename(count), "rb");
+        wxString statement;
+        if (!f.IsOpened() || !f.ReadAll(&statement))
+            return;
+        f.Close();
+        wxInt64 timestamp = wxFileModificationTime(getFilename(count));
+        if (!append(statement, timestamp))
+            return;
+        ++count;
+    }
+    for (Position i = 0; i < count; ++i)
+        wxRemoveFile(getFilename(i));
+}
+
+bool StatementHistory::append(const wxString& str, wxInt64 timestamp)
+{
+    wxScopedCharBuffer text(str.utf8_str());
+    Entry e;
+    e.offset = logSizeM;
+    e.length = text.length();
+    e.timestamp = timestamp;
+
+    std::string record;
+    record.reserve(recordHeaderSize + e.length);
+    appendUInt(record, e.length, 4);
+    appendUInt(record, wxUint64(e.timestamp), 8);
+    record.append(text.data(), e.length);
+
+    wxFFile log(getLogFilename(), "ab");
+    if (!log.IsOpened()
+        || log.Write(record.data(), record.size()) != record.size()
+        || !log.Close())
+    {
+        return false;
+    }
+    logSizeM += wxFileOffset(record.size());
+    entriesM.push_back(e);
+
+    std::string entry;
+    appendUInt(entry, wxUint64(e.offset), 8);
+    appendUInt(entry, e.length, 4);
+    appendUInt(entry, wxUint64(e.timestamp), 8);
+    wxFFile index(getIndexFilename(), "ab");
+    if (!index.IsOpened()
+        || index.Write(entry.data(), entry.size()) != entry.size()
+        || !index.Close())
+    {
+        // the next start will recreate the index from the log
+        wxRemoveFile(getIndexFilename());
+    }
+    return true;
+}
+
+void StatementHistory::compact()
+{
+    wxFFile log(getLogFilename(), "rb");
+    if (!log.IsOpened())
+        return;
+    std::string data;
+    std::vector<Entry> entries(entriesM);
+    for (std::vector<Entry>::iterator it = entries.begin();
+        it != entries.end(); ++it)
+    {
+        std::string record(recordHeaderSize + it->length, '\0');
+        if (!log.Seek(it->offset)
+            || log.Read(&record[0], record.size()) != record.size())
+        {
+            return;
+        }
+        it->offset = wxFileOffset(data.size());
+        data += record;
+    }
+    log.Close();
+
+    if (writeFile(getLogFilename(), data))
+    {
+        entriesM.swap(entries);
+        logSizeM = wxFileOffset(data.size());
+        writeIndex();
+    }
 }
 
 //! reads granularity from config() and gives pointer to appropriate history object
@@ -104,24 +356,21 @@ StatementHistory& StatementHistory::get(Database* db)
 
 wxDateTime StatementHistory::getDateTime(StatementHistory::Position pos)
 {
-    if (pos < sizeM)
-    {
-        return wxDateTime(::wxFileModificationTime(getFilename(pos)));
-    }
+    if (pos < entriesM.size())
+        return wxDateTime(time_t(entriesM[pos].timestamp));
     return wxInvalidDateTime;
 }
 
 wxString StatementHistory::get(StatementHistory::Position pos)
 {
-    if (pos < sizeM)
+    if (pos < entriesM.size())
     {
-        wxFFile f(getFilename(pos), "rb");
-        if (!f.IsOpened())
-            return wxEmptyString;
+        wxFFile f(getLogFilename(), "rb");
         wxString retval;
-        if (f.ReadAll(&retval))
+        if (f.IsOpened()
+            && readStatement(f, entriesM[pos].offset, entriesM[pos].length,
+                retval))
         {
-            f.Close();
             return retval;
         }
     }
@@ -137,47 +386,114 @@ void StatementHistory::add(const wxString& str)
         return;
     }
 
-    if (sizeM == 0 || get(sizeM-1) != str)
+    if (entriesM.empty() || get(entriesM.size() - 1) != str)
     {
-        wxFFile f(getFilename(sizeM), "wb+");
-        if (f.IsOpened())
-        {
-            f.Write(str);
-            f.Close();
-            sizeM++;
-        }
+        if (append(str, wxDateTime::Now().GetTicks()) && tokensLoadedM)
+            addTokens(entriesM.size() - 1, str);
     }
 }
 
 StatementHistory::Position StatementHistory::size()
 {
-    return sizeM;
+    return entriesM.size();
 }
 
 void StatementHistory::deleteItems(
     const std::vector<StatementHistory::Position>& items)
 {
-    // remove the files (remembering the "lowest" deleted)
-    Position start = size();
-    for (std::vector<Position>::const_iterator ci = items.begin();
-        ci != items.end(); ++ci)
+    std::set<Position> deleted(items.begin(), items.end());
+    std::vector<Entry> entries;
+    entries.reserve(entriesM.size());
+    wxFileOffset liveSize = 0;
+    for (Position pos = 0; pos < entriesM.size(); ++pos)
     {
-        wxRemoveFile(getFilename(*ci));
-        if ((*ci) < start)
-            start = (*ci);
+        if (deleted.find(pos) != deleted.end())
+            continue;
+        entries.push_back(entriesM[pos]);
+        liveSize += wxFileOffset(recordHeaderSize + entriesM[pos].length);
     }
+    entriesM.swap(entries);
+
+    // positions have changed, the token index will be rebuilt when needed
+    tokensM.clear();
+    tokensLoadedM = false;
 
-    // move existing files
-    for (Position currentpos = start; currentpos < size(); currentpos++)
+    // the records stay in the log until they outweigh the live ones
+    if (logSizeM - liveSize > liveSize)
+        compact();
+    else
+        writeIndex();
+}
+
+void StatementHistory::addTokens(StatementHistory::Position position,
+    const wxString& str)
+{
+    std::set<wxString> tokens(getTokens(str.Upper()));
+    for (std::set<wxString>::const_iterator it = tokens.begin();
+        it != tokens.end(); ++it)
     {
-        if (!wxFileExists(getFilename(currentpos)))
-            continue;
-        if (currentpos != start)
-            wxRenameFile(getFilename(currentpos), getFilename(start));
-        start++;
+        tokensM[*it].push_back(position);
     }
-
-    // set new size
-    sizeM = start;
 }
 
+std::vector<StatementHistory::Position> StatementHistory::search(
+    const wxString& text)
+{
+    std::vector<Position> result;
+    wxFFile log(getLogFilename(), "rb");
+    if (!log.IsOpened())
+        return result;
+
+    if (!tokensLoadedM)
+    {
+        tokensM.clear();
+        for (Position pos = 0; pos < entriesM.size(); ++pos)
+        {
+            wxString s;
+            if (readStatement(log, entriesM[pos].offset,
+                entriesM[pos].length, s))
+            {
+                addTokens(pos, s);
+            }
+        }
+        tokensLoadedM = true;
+    }
+
+    // every word of the search text must be part of a word of a matching
+    // statement, so only the statements containing such words need to be
+    // compared with the search text
+    wxString searchString(text.Upper());
+    std::vector<bool> candidates(entriesM.size(), true);
+    std::set<wxString> searchTokens(getTokens(searchString));
+    for (std::set<wxString>::const_iterator token = searchTokens.begin();
+        token != searchTokens.end(); ++token)
+    {
+        std::vector<bool> matches(entriesM.size(), false);
+        for (std::map<wxString, std::vector<Position> >::const_iterator it =
+            tokensM.begin(); it != tokensM.end(); ++it)
+        {
+            if (it->first.Contains(*token))
+            {
+                for (size_t i = 0; i < it->second.size(); ++i)
+                    matches[it->second[i]] = true;
+            }
+        }
+        for (Position pos = 0; pos < entriesM.size(); ++pos)
+            candidates[pos] = candidates[pos] && matches[pos];
+    }
+
+    for (Position pos = entriesM.size(); pos > 0; --pos)
+    {
+        if (!candidates[pos - 1])
+            continue;
+        wxString s;
+        if (!readStatement(log, entriesM[pos - 1].offset,
+            entriesM[pos - 1].length, s))
+        {
+            continue;
+        }
+        if (searchString.IsEmpty() || s.Upper().Contains(searchString))
+            result.push_back(pos - 1);
+    }
+    return result;
+}
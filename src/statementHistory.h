@@ -25,20 +25,50 @@
 #define FR_HISTORY_H
 
 #include <wx/wx.h>
+
+#include <map>
 #include <vector>
 
 class Database;
 
+// All statements of a history are kept in one append-only log file, with a
+// second file holding the offset, length and time of each statement, so
+// that add() and get() need not look at any other statement.  Deleted
+// statements are only removed from the index, the log is compacted when
+// it contains more deleted than live data.
 class StatementHistory
 {
 public:
     typedef size_t Position;
 
 private:
+    struct Entry
+    {
+        wxFileOffset offset;
+        size_t length;
+        wxInt64 timestamp;
+    };
     StatementHistory(const wxString& storageName);
     wxString getFilename(Position item);
+    wxString getBaseFilename();
+    wxString getLogFilename();
+    wxString getIndexFilename();
     wxString storageNameM;
-    Position sizeM;
+    std::vector<Entry> entriesM;
+    wxFileOffset logSizeM;
+
+    bool readIndex();
+    void rebuildIndex();
+    bool writeIndex();
+    void migrateLegacyItems();
+    bool append(const wxString& str, wxInt64 timestamp);
+    void compact();
+
+    // inverted index of the upper-cased words of all statements, built by
+    // the first search and maintained by add() afterwards
+    std::map<wxString, std::vector<Position> > tokensM;
+    bool tokensLoadedM;
+    void addTokens(Position position, const wxString& str);
 
 public:
     // copy ctor needed for std:: containers
@@ -51,6 +81,9 @@ public:
     wxDateTime getDateTime(Position position);
     void add(const wxString&);
     void deleteItems(const std::vector<Position>& items);
+    // returns the positions of all statements containing the text (case
+    // insensitive), newest first
+    std::vector<Position> search(const wxString& text);
     Position size();
 };
 